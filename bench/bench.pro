@@ -0,0 +1,9 @@
+# Benchmarks, built with QtTest.
+# Run one with -o result.json,json to get machine readable numbers.
+# bench_scene needs a display, or -platform offscreen.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+        io \
+        scene
@@ -0,0 +1,415 @@
+#include <QBuffer>
+#include <QMap>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "plan_record.hpp"
+#include "project_file.hpp"
+#include "json_interchange.hpp"
+
+/*
+ * Read and write throughput of the binary project format against the
+ * JSON interchange format, on in-memory buffers so the disk does not
+ * get in the way. The encoded size is printed next to each result,
+ * divide it by the time per iteration to get bytes per second.
+ *
+ * A few plain checks come first: incremental saves have to read back
+ * exactly what was saved, broken headers have to fail cleanly and both
+ * JSON readers have to agree on what is a plan.
+ */
+class BenchIo : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void saveChangesRoundTrip();
+    void rejectCorruptHeader_data();
+    void rejectCorruptHeader();
+    void streamRequiresFormat_data();
+    void streamRequiresFormat();
+
+    void writeBinary_data();
+    void writeBinary();
+    void writeJson_data();
+    void writeJson();
+
+    void readBinary_data();
+    void readBinary();
+    void readJsonDocument_data();
+    void readJsonDocument();
+    void readJsonStream_data();
+    void readJsonStream();
+
+private:
+    void addSizes();
+    QVector<PlanRecord> records(int count) const;
+    QByteArray encodeBinary(int count) const;
+    QByteArray encodeJson(int count) const;
+    void reportSize(const QByteArray &data) const;
+    void saveAndCompare(const QString &fileName, ProjectLayout &layout,
+                        QMap<quint64, PlanRecord> &expected,
+                        const QVector<PlanRecord> &changed, const QVector<quint64> &removed);
+
+    QVector<PlanRecord> m_records;
+};
+
+void BenchIo::initTestCase()
+{
+    /* A plain mix of rooms and furniture, deterministic between runs */
+    const int largest = 100000;
+    m_records.reserve(largest);
+    for (int i = 0; i < largest; i++) {
+        PlanRecord record;
+        record.id = quint64(i + 1);
+        record.kind = i % 10 == 0 ? PlanRecord::RoomKind : PlanRecord::FurnitureKind;
+        record.urlPath = record.kind == PlanRecord::RoomKind ? ":/img/furniture/floor/floor_light_3.jpg"
+                                                             : ":/img/furniture/beds/single_bed_white.png";
+        record.x = (i % 300) * 40;
+        record.y = (i / 300) * 40;
+        record.width = 40 + i % 7;
+        record.height = 30 + i % 5;
+        record.angle = (i % 4) * 90;
+        record.zValue = record.kind == PlanRecord::RoomKind ? -1 : i;
+        record.flipped = i % 3 == 0;
+        m_records.append(record);
+    }
+}
+
+void BenchIo::addSizes()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("100") << 100;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("100000") << 100000;
+}
+
+QVector<PlanRecord> BenchIo::records(int count) const
+{
+    return m_records.mid(0, count);
+}
+
+QByteArray BenchIo::encodeBinary(int count) const
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    ProjectWriter writer(&buffer);
+    writer.writeProject(records(count));
+    return buffer.data();
+}
+
+QByteArray BenchIo::encodeJson(int count) const
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    JsonPlanWriter writer(&buffer);
+    writer.writeStart();
+    for (const PlanRecord &record : records(count))
+        writer.writeRecord(record);
+    writer.writeEnd();
+    return buffer.data();
+}
+
+void BenchIo::reportSize(const QByteArray &data) const
+{
+    qInfo("%s: %d bytes", QTest::currentDataTag(), data.size());
+}
+
+/* Checks */
+
+/* Applies one incremental save to the file and to expected, then loads
+ * the file from scratch and compares every record */
+void BenchIo::saveAndCompare(const QString &fileName, ProjectLayout &layout,
+                             QMap<quint64, PlanRecord> &expected,
+                             const QVector<PlanRecord> &changed, const QVector<quint64> &removed)
+{
+    QString error;
+    QVERIFY2(ProjectWriter::saveChanges(fileName, layout, changed, removed, &error), qPrintable(error));
+    for (quint64 id : removed)
+        expected.remove(id);
+    for (const PlanRecord &record : changed)
+        expected.insert(record.id, record);
+
+    QVector<PlanRecord> loaded;
+    ProjectLayout reloaded;
+    QVERIFY2(ProjectReader::load(fileName, loaded, &error, &reloaded), qPrintable(error));
+    QCOMPARE(loaded.size(), expected.size());
+    QCOMPARE(layout.itemCount(), expected.size());
+    QCOMPARE(reloaded.itemCount(), expected.size());
+
+    for (const PlanRecord &record : loaded) {
+        QVERIFY(expected.contains(record.id));
+        QVERIFY(record == expected.value(record.id));
+    }
+
+    /* The index written matches what the writer kept in memory */
+    for (auto it = reloaded.chunkOf.constBegin(); it != reloaded.chunkOf.constEnd(); ++it)
+        QVERIFY(layout.chunkOf.contains(it.key()));
+}
+
+void BenchIo::saveChangesRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath("plan.hp2d");
+
+    const QVector<PlanRecord> initial = records(1000);
+    ProjectLayout layout;
+    QVERIFY(ProjectWriter::save(fileName, initial, nullptr, &layout));
+
+    QMap<quint64, PlanRecord> expected;
+    for (const PlanRecord &record : initial)
+        expected.insert(record.id, record);
+
+    /* Edits scattered over every chunk */
+    QVector<PlanRecord> changed;
+    for (int i = 0; i < initial.size(); i += 7) {
+        PlanRecord record = initial.at(i);
+        record.x += 15;
+        record.angle = 45;
+        changed.append(record);
+    }
+    saveAndCompare(fileName, layout, expected, changed, QVector<quint64>());
+    if (QTest::currentTestFailed())
+        return;
+
+    /* A whole chunk and a few records elsewhere go */
+    QVector<quint64> removed;
+    for (int i = ProjectFile::ChunkSize; i < 2 * ProjectFile::ChunkSize; i++)
+        removed.append(initial.at(i).id);
+    for (int i = 3; i < initial.size(); i += 13)
+        removed.append(initial.at(i).id);
+    saveAndCompare(fileName, layout, expected, QVector<PlanRecord>(), removed);
+    if (QTest::currentTestFailed())
+        return;
+
+    /* New records, more than one chunk of them */
+    QVector<PlanRecord> fresh;
+    for (int i = 0; i < ProjectFile::ChunkSize + 44; i++) {
+        PlanRecord record = initial.at(i);
+        record.id = quint64(initial.size() + i + 1);
+        record.urlPath = ":/img/furniture/tables/table_round.png";
+        fresh.append(record);
+    }
+    saveAndCompare(fileName, layout, expected, fresh, QVector<quint64>());
+    if (QTest::currentTestFailed())
+        return;
+
+    /* Edits and removals among the records just added and the old ones */
+    changed.clear();
+    removed.clear();
+    for (int i = 0; i < fresh.size(); i += 5) {
+        PlanRecord record = fresh.at(i);
+        record.flipped = !record.flipped;
+        changed.append(record);
+    }
+    for (int i = 1; i < fresh.size(); i += 9)
+        removed.append(fresh.at(i).id);
+    changed.append(initial.at(999));
+    changed.last().zValue = -5;
+    saveAndCompare(fileName, layout, expected, changed, removed);
+    if (QTest::currentTestFailed())
+        return;
+
+    QVERIFY(layout.deadBytes > 0);
+}
+
+/* A copy of data with value written over it at position */
+template <class T>
+static QByteArray patched(QByteArray data, qint64 position, T value)
+{
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadWrite);
+    buffer.seek(position);
+    QDataStream out(&buffer);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << value;
+    return data;
+}
+
+/* Header fields, see project_file.hpp */
+void BenchIo::rejectCorruptHeader_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    const QByteArray good = encodeBinary(300);
+    qint64 indexOffset;
+    {
+        QDataStream in(good);
+        in.setVersion(QDataStream::Qt_5_12);
+        in.skipRawData(12);
+        in >> indexOffset;
+    }
+
+    QTest::newRow("truncated header") << good.left(16);
+    QTest::newRow("truncated index") << good.left(int(indexOffset) + 6);
+    QTest::newRow("index past the end") << patched(good, 12, qint64(good.size() + 100));
+    QTest::newRow("index inside the header") << patched(good, 12, qint64(4));
+    QTest::newRow("negative index") << patched(good, 12, qint64(-8));
+    QTest::newRow("huge chunk count") << patched(good, indexOffset, quint32(0x7fffffff));
+    QTest::newRow("huge item count") << patched(good, 8, quint32(0xffffffff));
+}
+
+void BenchIo::rejectCorruptHeader()
+{
+    QFETCH(QByteArray, data);
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    ProjectReader reader(&buffer);
+    QVERIFY(!reader.readHeader());
+    QVERIFY(reader.hasError());
+    QVERIFY(!reader.errorString().isEmpty());
+}
+
+/* Files above DocumentLimit are streamed, both readers have to turn
+ * away the same documents */
+void BenchIo::streamRequiresFormat_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("valid");
+
+    const QByteArray item = "{\"id\":1,\"kind\":\"room\",\"x\":0,\"y\":0}";
+    QTest::newRow("plan") << QByteArray("{\"format\":\"home-planner-2d\",\"version\":1,\"items\":[" + item + "]}") << true;
+    QTest::newRow("no items") << QByteArray("{\"format\":\"home-planner-2d\",\"version\":1}") << true;
+    QTest::newRow("no format") << QByteArray("{\"version\":1,\"items\":[" + item + "]}") << false;
+    QTest::newRow("empty object") << QByteArray("{}") << false;
+    QTest::newRow("wrong format") << QByteArray("{\"format\":\"other\",\"items\":[" + item + "]}") << false;
+}
+
+void BenchIo::streamRequiresFormat()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, valid);
+
+    QVector<PlanRecord> document;
+    QCOMPARE(JsonInterchange::readDocument(data, document), valid);
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    JsonPlanReader reader(&buffer);
+    QVector<PlanRecord> streamed;
+    PlanRecord record;
+    while (reader.readNext(record))
+        streamed.append(record);
+    QCOMPARE(!reader.hasError(), valid);
+    if (valid)
+        QCOMPARE(streamed.size(), document.size());
+}
+
+/* Writing */
+
+void BenchIo::writeBinary_data()
+{
+    addSizes();
+}
+
+void BenchIo::writeBinary()
+{
+    QFETCH(int, count);
+    const QVector<PlanRecord> input = records(count);
+
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        ProjectWriter writer(&buffer);
+        writer.writeProject(input);
+    }
+    reportSize(encodeBinary(count));
+}
+
+void BenchIo::writeJson_data()
+{
+    addSizes();
+}
+
+void BenchIo::writeJson()
+{
+    QFETCH(int, count);
+    const QVector<PlanRecord> input = records(count);
+
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        JsonPlanWriter writer(&buffer);
+        writer.writeStart();
+        for (const PlanRecord &record : input)
+            writer.writeRecord(record);
+        writer.writeEnd();
+    }
+    reportSize(encodeJson(count));
+}
+
+/* Reading */
+
+void BenchIo::readBinary_data()
+{
+    addSizes();
+}
+
+void BenchIo::readBinary()
+{
+    QFETCH(int, count);
+    QByteArray data = encodeBinary(count);
+
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        ProjectReader reader(&buffer);
+        QVERIFY(reader.readHeader());
+
+        QVector<PlanRecord> chunk;
+        int read = 0;
+        while (reader.readChunk(chunk))
+            read += chunk.size();
+        QCOMPARE(read, count);
+    }
+    reportSize(data);
+}
+
+void BenchIo::readJsonDocument_data()
+{
+    addSizes();
+}
+
+void BenchIo::readJsonDocument()
+{
+    QFETCH(int, count);
+    const QByteArray data = encodeJson(count);
+
+    QBENCHMARK {
+        QVector<PlanRecord> result;
+        QVERIFY(JsonInterchange::readDocument(data, result));
+        QCOMPARE(result.size(), count);
+    }
+    reportSize(data);
+}
+
+void BenchIo::readJsonStream_data()
+{
+    addSizes();
+}
+
+void BenchIo::readJsonStream()
+{
+    QFETCH(int, count);
+    QByteArray data = encodeJson(count);
+
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        JsonPlanReader reader(&buffer);
+
+        PlanRecord record;
+        int read = 0;
+        while (reader.readNext(record))
+            read++;
+        QVERIFY(!reader.hasError());
+        QCOMPARE(read, count);
+    }
+    reportSize(data);
+}
+
+QTEST_GUILESS_MAIN(BenchIo)
+#include "bench_io.moc"
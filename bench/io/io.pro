@@ -0,0 +1,10 @@
+QT += core testlib
+QT -= gui
+
+TARGET = bench_io
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+include(../../src/core.pri)
+
+SOURCES += bench_io.cpp
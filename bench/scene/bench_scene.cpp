@@ -0,0 +1,458 @@
+#include <QGraphicsView>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtTest>
+
+#include "plan_scene.hpp"
+#include "room.hpp"
+#include "furniture.hpp"
+#include "furniture_asset.hpp"
+#include "default_plan.hpp"
+#include "image_cache.hpp"
+#include "plan_generator.hpp"
+
+/*
+ * Drawing, populating, editing and exporting plans, everything that
+ * happens in the scene rather than in the file formats (see bench_io).
+ *
+ *   bench_scene -platform offscreen -o -,txt -o bench_scene.json,json
+ *
+ * Images are decoded before the timed part, the numbers are for a
+ * warm ImageCache like in a running planner.
+ */
+class BenchScene : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void paintRoom_data();
+    void paintRoom();
+    void paintFurniture_data();
+    void paintFurniture();
+
+    void addItems_data();
+    void addItems();
+    void clearIdentical_data();
+    void clearIdentical();
+    void defaultApartment();
+
+    void selectAll_data();
+    void selectAll();
+    void moveSelection_data();
+    void moveSelection();
+    void movePartOfScene_data();
+    void movePartOfScene();
+    void rotateSelection_data();
+    void rotateSelection();
+    void rotateGroup_data();
+    void rotateGroup();
+    void flipSelection_data();
+    void flipSelection();
+
+    void exportImage_data();
+    void exportImage();
+    void exportView();
+
+    void addGenerated_data();
+    void addGenerated();
+    void exportGenerated_data();
+    void exportGenerated();
+
+private:
+    void addSizes();
+    void populate(PlanScene &scene, int count) const;
+    void selectEverything(PlanScene &scene) const;
+    void addGeneratedSizes();
+
+    QVector<PlanRecord> m_records;
+};
+
+/* Furniture::paint is protected, the scene is the only caller in the planner */
+class PaintableFurniture : public Furniture
+{
+public:
+    using Furniture::Furniture;
+    using Furniture::paint;
+};
+
+static const char *const FloorTexture = ":/img/furniture/floor/floor_light_3.jpg";
+static const char *const FurnitureImage = ":/img/furniture/beds/single_bed_white.png";
+
+void BenchScene::initTestCase()
+{
+    /* Furniture on a grid, with a room under every tenth piece.
+     * Deterministic between runs. */
+    const int largest = 10000;
+    m_records.reserve(largest);
+    for (int i = 0; i < largest; i++) {
+        PlanRecord record;
+        record.kind = i % 10 == 0 ? PlanRecord::RoomKind : PlanRecord::FurnitureKind;
+        record.urlPath = record.kind == PlanRecord::RoomKind ? FloorTexture : FurnitureImage;
+        record.x = (i % 100) * 50;
+        record.y = (i / 100) * 50;
+        record.width = record.kind == PlanRecord::RoomKind ? 200 : 40 + i % 7;
+        record.height = record.kind == PlanRecord::RoomKind ? 150 : 30 + i % 5;
+        record.angle = (i % 4) * 90;
+        record.zValue = record.kind == PlanRecord::RoomKind ? -1 : i;
+        record.flipped = i % 3 == 0;
+        m_records.append(record);
+    }
+
+    ImageCache::pixmap(FloorTexture);
+    ImageCache::pixmap(FurnitureImage);
+}
+
+void BenchScene::addSizes()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void BenchScene::populate(PlanScene &scene, int count) const
+{
+    for (int i = 0; i < count; i++)
+        scene.addRecord(m_records.at(i));
+}
+
+void BenchScene::selectEverything(PlanScene &scene) const
+{
+    for (QGraphicsItem *item : scene.items())
+        item->setSelected(true);
+}
+
+void BenchScene::paintRoom_data()
+{
+    QTest::addColumn<QString>("floor");
+    QTest::newRow("plain") << QString();
+    QTest::newRow("textured") << QString(FloorTexture);
+}
+
+void BenchScene::paintRoom()
+{
+    QFETCH(QString, floor);
+
+    PlanScene scene;
+    Room *room = new Room(6.5*33, 4*33, floor);
+    scene.addItem(room);
+
+    QImage image(256, 256, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QStyleOptionGraphicsItem option;
+    option.exposedRect = room->boundingRect();
+
+    QBENCHMARK {
+        room->paint(&painter, &option);
+    }
+}
+
+void BenchScene::paintFurniture_data()
+{
+    QTest::addColumn<bool>("flipped");
+    QTest::newRow("unflipped") << false;
+    QTest::newRow("flipped") << true;
+}
+
+void BenchScene::paintFurniture()
+{
+    QFETCH(bool, flipped);
+
+    PlanScene scene;
+    PaintableFurniture *furniture = new PaintableFurniture(FurnitureImage, 40, 60);
+    scene.addItem(furniture);
+    if (flipped)
+        furniture->swapFlipped();
+
+    QImage image(128, 128, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QStyleOptionGraphicsItem option;
+    option.exposedRect = furniture->boundingRect();
+
+    QBENCHMARK {
+        furniture->paint(&painter, &option);
+    }
+}
+
+void BenchScene::addItems_data()
+{
+    addSizes();
+}
+
+/* Items are built and added one by one, like the catalog and import do.
+ * Tearing the scene down is part of every iteration. */
+void BenchScene::addItems()
+{
+    QFETCH(int, count);
+
+    QBENCHMARK {
+        PlanScene scene;
+        for (int i = 0; i < count; i++) {
+            const PlanRecord &record = m_records.at(i);
+            if (record.kind == PlanRecord::RoomKind)
+                scene.addItem(new Room(record));
+            else
+                scene.addItem(new Furniture(record));
+        }
+        QCOMPARE(scene.items().size(), count);
+    }
+}
+
+void BenchScene::clearIdentical_data()
+{
+    addSizes();
+}
+
+/* One catalog piece over and over, then Clear All. The pieces share one
+ * FurnitureAsset and, after the first iteration, reuse pooled blocks. */
+void BenchScene::clearIdentical()
+{
+    QFETCH(int, count);
+    const FurnitureAsset *asset = FurnitureAsset::define(FurnitureImage, 35, 35);
+
+    PlanScene scene;
+    QBENCHMARK {
+        for (int i = 0; i < count; i++)
+            scene.addItem(new Furniture(asset));
+        scene.clear();
+    }
+}
+
+/* What 'Use Default Template' does: TemplateWindow::drawGraphicsScene
+ * followed by setDefaultApartmentScheme */
+void BenchScene::defaultApartment()
+{
+    QBENCHMARK {
+        PlanScene scene;
+        scene.setRoomsLocked(true);
+        QList<QGraphicsItem*> rooms;
+        QList<Furniture*> doors;
+        DefaultPlan::apartment(rooms, doors);
+
+        for (QGraphicsItem *room : rooms)
+            scene.addItem(room);
+        for (Furniture *door : doors)
+            scene.addItem(door);
+    }
+}
+
+void BenchScene::selectAll_data()
+{
+    addSizes();
+}
+
+void BenchScene::selectAll()
+{
+    QFETCH(int, count);
+
+    PlanScene scene;
+    populate(scene, count);
+
+    QBENCHMARK {
+        selectEverything(scene);
+        QCOMPARE(scene.selection().size(), count);
+        scene.clearSelection();
+    }
+}
+
+void BenchScene::moveSelection_data()
+{
+    addSizes();
+}
+
+void BenchScene::moveSelection()
+{
+    QFETCH(int, count);
+
+    PlanScene scene;
+    populate(scene, count);
+    selectEverything(scene);
+
+    QBENCHMARK {
+        scene.moveItems(scene.selection().items(), 5, 0);
+    }
+}
+
+void BenchScene::movePartOfScene_data()
+{
+    addSizes();
+}
+
+/* A selection out of the largest scene: small ones update the index item
+ * by item, see PlanScene::IndexRebuildFraction, the full one rebuilds it */
+void BenchScene::movePartOfScene()
+{
+    QFETCH(int, count);
+
+    PlanScene scene;
+    populate(scene, 10000);
+    const QList<QGraphicsItem*> items = scene.items();
+    for (int i = 0; i < count; i++)
+        items.at(i)->setSelected(true);
+
+    QBENCHMARK {
+        scene.moveItems(scene.selection().items(), 5, 0);
+    }
+}
+
+void BenchScene::rotateSelection_data()
+{
+    addSizes();
+}
+
+void BenchScene::rotateSelection()
+{
+    QFETCH(int, count);
+
+    PlanScene scene;
+    populate(scene, count);
+    selectEverything(scene);
+
+    QBENCHMARK {
+        scene.rotateItems(scene.selection().items(), 90);
+    }
+}
+
+void BenchScene::rotateGroup_data()
+{
+    addSizes();
+}
+
+void BenchScene::rotateGroup()
+{
+    QFETCH(int, count);
+
+    PlanScene scene;
+    populate(scene, count);
+    selectEverything(scene);
+
+    QBENCHMARK {
+        scene.rotateGroup(scene.selection().items(), 90);
+    }
+}
+
+void BenchScene::flipSelection_data()
+{
+    addSizes();
+}
+
+void BenchScene::flipSelection()
+{
+    QFETCH(int, count);
+
+    PlanScene scene;
+    populate(scene, count);
+    selectEverything(scene);
+
+    QBENCHMARK {
+        scene.flipItems(scene.selection().items());
+    }
+}
+
+void BenchScene::exportImage_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<qreal>("scale");
+    QTest::newRow("100 x1") << 100 << qreal(1);
+    QTest::newRow("1000 x1") << 1000 << qreal(1);
+    QTest::newRow("1000 x2") << 1000 << qreal(2);
+}
+
+/* The headless export used by batch_render */
+void BenchScene::exportImage()
+{
+    QFETCH(int, count);
+    QFETCH(qreal, scale);
+
+    PlanScene scene;
+    populate(scene, count);
+
+    QBENCHMARK {
+        const QImage image = scene.toImage(scale, 10);
+        QVERIFY(!image.isNull());
+    }
+}
+
+/* 'Save as Image' grabs the view, which draws the default apartment */
+void BenchScene::exportView()
+{
+    PlanScene scene;
+    QList<QGraphicsItem*> rooms;
+    QList<Furniture*> doors;
+    DefaultPlan::apartment(rooms, doors);
+    for (QGraphicsItem *room : rooms)
+        scene.addItem(room);
+    for (Furniture *door : doors)
+        scene.addItem(door);
+
+    QGraphicsView view(&scene);
+    view.resize(1024, 768);
+    view.setRenderHint(QPainter::SmoothPixmapTransform);
+    view.scale(1.5, 1.5);
+
+    QBENCHMARK {
+        const QPixmap pixmap = view.grab();
+        QVERIFY(!pixmap.isNull());
+    }
+}
+
+/* Realistic plans from PlanGenerator, the seed is fixed */
+void BenchScene::addGeneratedSizes()
+{
+    QTest::addColumn<int>("layout");
+    QTest::addColumn<int>("rooms");
+    QTest::newRow("apartment 8") << int(PlanGenerator::Apartment) << 8;
+    QTest::newRow("house 40") << int(PlanGenerator::House) << 40;
+    QTest::newRow("office 400") << int(PlanGenerator::Office) << 400;
+}
+
+void BenchScene::addGenerated_data()
+{
+    addGeneratedSizes();
+}
+
+void BenchScene::addGenerated()
+{
+    QFETCH(int, layout);
+    QFETCH(int, rooms);
+
+    PlanGenerator::Options options;
+    options.layout = PlanGenerator::Layout(layout);
+    options.rooms = rooms;
+    const QVector<PlanRecord> records = PlanGenerator::generate(options);
+
+    QBENCHMARK {
+        PlanScene scene;
+        for (const PlanRecord &record : records)
+            scene.addRecord(record);
+    }
+}
+
+void BenchScene::exportGenerated_data()
+{
+    addGeneratedSizes();
+}
+
+void BenchScene::exportGenerated()
+{
+    QFETCH(int, layout);
+    QFETCH(int, rooms);
+
+    PlanGenerator::Options options;
+    options.layout = PlanGenerator::Layout(layout);
+    options.rooms = rooms;
+
+    PlanScene scene;
+    for (const PlanRecord &record : PlanGenerator::generate(options))
+        scene.addRecord(record);
+
+    QBENCHMARK {
+        const QImage image = scene.toImage(0.5);
+        QVERIFY(!image.isNull());
+    }
+}
+
+QTEST_MAIN(BenchScene)
+#include "bench_scene.moc"
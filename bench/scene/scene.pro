@@ -0,0 +1,9 @@
+QT += core gui widgets testlib
+
+TARGET = bench_scene
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+include(../../src/scene.pri)
+
+SOURCES += bench_scene.cpp
@@ -0,0 +1,14 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+        core \
+        app \
+        tools \
+        bench
+
+core.subdir = src/core
+app.subdir = src
+
+app.depends = core
+tools.depends = core
+bench.depends = core
@@ -0,0 +1,15 @@
+# Links the plan core library (core/core.pro), QtCore only.
+# Shared by the application, the benchmarks and the command line tools,
+# which are built from home_planner.pro so the library comes first.
+
+INCLUDEPATH += $$PWD/headers
+DEPENDPATH += $$PWD/headers
+
+CORE_LIB_DIR = $$shadowed($$PWD)/core
+win32:CONFIG(debug, debug|release): CORE_LIB_DIR = $$CORE_LIB_DIR/debug
+else:win32: CORE_LIB_DIR = $$CORE_LIB_DIR/release
+
+LIBS += -L$$CORE_LIB_DIR -lplanner_core
+
+win32-msvc*: PRE_TARGETDEPS += $$CORE_LIB_DIR/planner_core.lib
+else: PRE_TARGETDEPS += $$CORE_LIB_DIR/libplanner_core.a
@@ -0,0 +1,44 @@
+# Plan model, geometry and file formats as a static library, QtCore only.
+# Link it with include(../core.pri).
+
+QT = core
+
+TEMPLATE = lib
+TARGET = planner_core
+CONFIG += staticlib c++11
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+        ../source/plan_record.cpp \
+        ../source/plan_op.cpp \
+        ../source/plan_geometry.cpp \
+        ../source/plan_model.cpp \
+        ../source/plan_snapshot.cpp \
+        ../source/plan_analysis.cpp \
+        ../source/project_file.cpp \
+        ../source/json_interchange.cpp \
+        ../source/asset_store.cpp \
+        ../source/project_bundle.cpp \
+        ../source/plan_loader.cpp \
+        ../source/trace.cpp \
+        ../source/plan_generator.cpp \
+        ../source/startup_timer.cpp \
+        ../source/item_pool.cpp
+
+HEADERS += \
+        ../headers/plan_record.hpp \
+        ../headers/plan_op.hpp \
+        ../headers/plan_geometry.hpp \
+        ../headers/plan_model.hpp \
+        ../headers/plan_snapshot.hpp \
+        ../headers/plan_analysis.hpp \
+        ../headers/project_file.hpp \
+        ../headers/json_interchange.hpp \
+        ../headers/asset_store.hpp \
+        ../headers/project_bundle.hpp \
+        ../headers/plan_loader.hpp \
+        ../headers/trace.hpp \
+        ../headers/plan_generator.hpp \
+        ../headers/startup_timer.hpp \
+        ../headers/item_pool.hpp
@@ -0,0 +1,25 @@
+#ifndef ASSET_STORE_HPP
+#define ASSET_STORE_HPP
+
+#include <QByteArray>
+#include <QString>
+
+/*
+ * Images that came with a project bundle instead of the application
+ * resources. They are kept compressed and addressed by the SHA-1 of their
+ * content ("asset:<hex>" urls), so identical images exist only once.
+ * ImageCache decodes an image the first time something draws it.
+ */
+class AssetStore
+{
+public:
+    static bool isAsset(const QString &urlPath);
+    static QString urlFor(const QByteArray &hash);
+    static QByteArray hashOf(const QString &urlPath);
+
+    /* Registers zlib-compressed image data, returns its url */
+    static QString add(const QByteArray &hash, const QByteArray &compressed);
+    static QByteArray compressedData(const QString &urlPath);
+};
+
+#endif // ASSET_STORE_HPP
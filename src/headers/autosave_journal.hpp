@@ -0,0 +1,79 @@
+#ifndef AUTOSAVE_JOURNAL_HPP
+#define AUTOSAVE_JOURNAL_HPP
+
+#include <QLockFile>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "plan_op.hpp"
+
+/*
+ * Crash recovery for the furnishing stage.
+ *
+ * The GUI thread only queues PlanOp records (a mutex and a vector append).
+ * A background thread writes the plan a session starts from to
+ * snapshot.hp2d, appends the operations to journal.log, keeps its own copy
+ * of the plan up to date, and every CompactThreshold operations writes that
+ * copy to snapshot.hp2d and truncates the journal.
+ * On startup, snapshot + journal give back the plan as it was before a crash.
+ */
+class AutosaveJournal : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit AutosaveJournal(QString directory = defaultDirectory(),
+                             QObject *parent = nullptr);
+    ~AutosaveJournal() override;
+
+    static QString defaultDirectory();
+    static const int CompactThreshold = 2000;   // Operations between snapshots
+    static const int FlushInterval    = 1000;   // ms
+
+    /* False if another window already journals into the same directory */
+    bool isAvailable() const;
+
+    /* Left over from a session that did not end cleanly */
+    bool hasRecoveryData() const;
+    QVector<PlanRecord> recover() const;
+
+    /* Starts a new session from the given plan, old data is dropped once
+     * the background thread has written it */
+    void startSession(const QVector<PlanRecord> &records);
+    /* Clean shutdown, nothing to recover next time */
+    void discard();
+
+public slots:
+    /* Called on the GUI thread for every change */
+    void record(const PlanOp &op);
+
+protected:
+    void run() override;
+
+private:
+    QVector<PlanOp> foldOps(const QVector<PlanOp> &ops);
+    void compact();
+    void stopThread();
+
+    QString m_directory;
+    QLockFile m_lock;
+    bool m_locked;
+
+    /* Shared with the background thread */
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QVector<PlanOp> m_pending;
+    bool m_stop;
+
+    /* Handed to the background thread when it starts */
+    QVector<PlanRecord> m_startRecords;
+
+    /* Background thread only, once it is running */
+    QMap<quint64, PlanRecord> m_state;
+    int m_opsSinceSnapshot;
+};
+
+#endif // AUTOSAVE_JOURNAL_HPP
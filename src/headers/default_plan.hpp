@@ -0,0 +1,16 @@
+#ifndef DEFAULT_PLAN_HPP
+#define DEFAULT_PLAN_HPP
+
+#include <QList>
+
+#include "furniture.hpp"
+
+class QGraphicsItem;
+
+/* The five room apartment behind 'Use Default Template'. Nothing is added
+ * to a scene: rooms have to go in first, the doors on top of them. */
+namespace DefaultPlan {
+    void apartment(QList<QGraphicsItem*> &rooms, QList<Furniture*> &doors);
+}
+
+#endif // DEFAULT_PLAN_HPP
@@ -6,6 +6,7 @@
 
 #include "centered_window.hpp"
 #include "template_window.hpp"
+#include "plan_scene.hpp"
 
 namespace Ui {
 class DesignWindow;
@@ -20,17 +21,29 @@ public:
     ~DesignWindow() override;   // 'override' needed because of keypressevent
     void keyPressEvent(QKeyEvent *event) override;
 
+    /* Empty plan and initial zoom, for starting over in the same window */
+    void reset();
+
+    /* Gives the plan away as it is and carries on with an empty one */
+    PlanScene *takeScene();
+
 private:
     Ui::DesignWindow *ui;
-    QGraphicsScene *scene;
-    TemplateWindow *tempWind;
+    PlanScene *scene;
+    void createScene();
+
+    /* Floor texture for every selected room */
+    void setSelectedFloor(const QString &urlPath);
 
 private slots:
 
     /* Menu bar options */
+    void on_actionCustomFloor_triggered();
     void on_actionClear_All_triggered();
     void on_actionShortcuts_triggered();
     void on_actionQuit_triggered();
+    void on_actionPerformanceOverlay_toggled(bool checked);
+    void on_actionMemoryUsage_triggered();
     void on_btnNext_clicked();
 
     /* Scene manipulation */
@@ -1,25 +1,42 @@
 #ifndef FURNITURE_HPP
 #define FURNITURE_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <QGraphicsItem>
-#include <QPen>
 
+#include "plan_op.hpp"
+#include "plan_model.hpp"
+#include "furniture_asset.hpp"
+#include "item_pool.hpp"
+
+/* View of a piece of furniture kept by the PlanModel of its scene. The
+ * image is shared with every piece showing it, see FurnitureAsset, and
+ * the item itself comes from a pool. */
 class Furniture : public QGraphicsItem
 {
 public:
     Furniture (QString urlPath, int width, int height, QGraphicsItem *parent = nullptr);
+    /* A catalog piece at its catalog size */
+    explicit Furniture(const FurnitureAsset *asset, QGraphicsItem *parent = nullptr);
+    explicit Furniture(const PlanRecord &record, QGraphicsItem *parent = nullptr);
     ~Furniture() override;
 
+    static void *operator new(std::size_t size);
+    static void operator delete(void *block, std::size_t size);
+
 protected:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
                QWidget *widget = nullptr) override;
 
     QRectF boundingRect() const override;
     void keyPressEvent(QKeyEvent *event) override;
+    void keyReleaseEvent(QKeyEvent *event) override;
     void mousePressEvent(QGraphicsSceneMouseEvent * event) override;
     void hoverEnterEvent(QGraphicsSceneHoverEvent *event) override;
     void hoverLeaveEvent(QGraphicsSceneHoverEvent *event) override;
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event) override;
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
 
 public:
 
@@ -27,20 +44,35 @@ public:
     enum { Type = UserType + 1 };
     int type() const override;
 
+    quint64 id() const;
+    PlanRecord record() const;
+    const FurnitureAsset *asset() const;
+
+    /* Changed since the project was last saved */
+    bool isDirty() const;
+    void clearDirty();
+
     void move(qreal x, qreal y);
     void rotate(qreal angleParam);
     void swapFlipped();
     bool isFlipped() const;
-    static int numberFurniture;     // Furniture counter
+    static std::atomic<int> numberFurniture;     // Furniture counter
+    static ItemPool::Usage poolUsage();
+    /* Frees the pool chunks no piece uses any more */
+    static void trimPool();
 
 private:
-    QPen m_pen;
-    qreal angle;
-    int m_width;
-    int m_height;
-    qreal zValue;
-    bool m_isFlipped;
-    QString m_urlPath;
+    Furniture(const FurnitureAsset *asset, int width, int height, QGraphicsItem *parent);
+
+    const PlanItem &planItem() const;
+    void followScene();
+    void notifyScene(PlanOp::Type type);
+    void markDirty();
+
+    PlanModel *m_model;
+    quint64 m_id;
+    const FurnitureAsset *m_asset;
+    bool m_dirty;
 };
 
 #endif // FURNITURE_HPP
@@ -0,0 +1,56 @@
+#ifndef FURNITURE_ASSET_HPP
+#define FURNITURE_ASSET_HPP
+
+#include <QAtomicInt>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+/*
+ * What every piece of furniture showing the same image has in common:
+ * the image's url, the size the catalog gives it and the decoded image.
+ * There is one asset per url for the whole application, so a plan with
+ * a thousand identical chairs keeps one of each, and pieces only point
+ * to it. Where a piece is and how large it is stays in the PlanModel.
+ *
+ * Pieces count as users of their asset. Assets nobody uses are freed by
+ * trim(), except catalog ones, which the catalog buttons keep: those only
+ * let go of their image. acquire() and define() work on any thread.
+ */
+class FurnitureAsset
+{
+public:
+    /* The asset for urlPath, made on first use, with one more user */
+    static const FurnitureAsset *acquire(const QString &urlPath);
+    /* Same for the catalog, with the size new pieces get. Not a user. */
+    static const FurnitureAsset *define(const QString &urlPath, int width, int height);
+    static int count();
+
+    /* One more user of an asset the caller already has */
+    void addUser() const;
+    void release() const;
+
+    /* Frees the assets nobody uses and drops the images of unused catalog
+     * ones, so ImageCache::trim() can free their pixels. GUI thread only. */
+    static void trim();
+
+    const QString &urlPath() const;
+    /* Empty for images that are not in the catalog */
+    QSize catalogSize() const;
+
+    /* Decoded on the first call, then handed out without a cache lookup.
+     * GUI thread only, like every QPixmap. */
+    const QPixmap &pixmap() const;
+
+private:
+    explicit FurnitureAsset(const QString &urlPath);
+    Q_DISABLE_COPY(FurnitureAsset)
+
+    QString m_urlPath;
+    QSize m_catalogSize;
+    mutable QPixmap m_pixmap;
+    mutable QAtomicInt m_decoded;
+    mutable QAtomicInt m_users;
+};
+
+#endif // FURNITURE_ASSET_HPP
@@ -0,0 +1,39 @@
+#ifndef FURNITURE_CATALOG_HPP
+#define FURNITURE_CATALOG_HPP
+
+#include <QWidget>
+
+#include "furniture_asset.hpp"
+
+namespace Ui {
+class FurnitureCatalog;
+}
+
+/*
+ * The furniture pages of the furnishing window: two hundred image buttons,
+ * each adding one piece. Which image at which size is a table in
+ * furniture_catalog.cpp, keyed by button name, and every entry becomes
+ * the FurnitureAsset its pieces share.
+ *
+ * A form of its own so TemplateWindow can show the plan first and build
+ * the pages once that frame is out.
+ */
+class FurnitureCatalog : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit FurnitureCatalog(QWidget *parent = nullptr);
+    ~FurnitureCatalog() override;
+
+    /* Back to the first page */
+    void reset();
+
+signals:
+    void furnitureChosen(const FurnitureAsset *asset);
+
+private:
+    Ui::FurnitureCatalog *ui;
+};
+
+#endif // FURNITURE_CATALOG_HPP
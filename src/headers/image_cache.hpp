@@ -0,0 +1,55 @@
+#ifndef IMAGE_CACHE_HPP
+#define IMAGE_CACHE_HPP
+
+#include <QBrush>
+#include <QColor>
+#include <QImage>
+#include <QPixmap>
+#include <QString>
+
+/* Decoded floor textures and furniture images, shared by every scene.
+ * Each url is decoded once per kind of thread that draws it: the GUI
+ * thread keeps QPixmaps, headless renderers on worker threads QImages.
+ * Decoding happens outside of the cache lock, so workers decode in
+ * parallel. */
+class ImageCache
+{
+public:
+    /* QPixmap may only be used here */
+    static bool isGuiThread();
+
+    /* Works for every url: resources, files on disk and assets.
+     * GUI thread only. */
+    static QPixmap pixmap(const QString &urlPath);
+    /* Same for any thread */
+    static QImage image(const QString &urlPath);
+
+    /* Cheap stand-ins for frames drawn while the view moves. Sprites are
+     * scaled down once to the next power of two above size pixels, so a
+     * handful per image serves every zoom level. */
+    static QPixmap sprite(const QString &urlPath, int size);
+    static QImage spriteImage(const QString &urlPath, int size);
+    static QColor averageColor(const QString &urlPath);
+
+    /* Floor textures as rooms tile them, any thread */
+    static QBrush floorBrush(const QString &urlPath);
+
+    /* What the cache holds, pixel data only. Images count both kinds. */
+    struct Usage
+    {
+        int pixmaps = 0;
+        qint64 pixmapBytes = 0;
+        int sprites = 0;
+        qint64 spriteBytes = 0;
+        int brushes = 0;
+        qint64 brushBytes = 0;
+    };
+    static Usage usage();
+
+    /* Drops the images and sprites nothing outside the cache holds on to,
+     * the next lookup decodes them again. Colors and floor brushes are
+     * small and stay. GUI thread only, like every QPixmap. */
+    static void trim();
+};
+
+#endif // IMAGE_CACHE_HPP
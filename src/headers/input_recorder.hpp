@@ -0,0 +1,68 @@
+#ifndef INPUT_RECORDER_HPP
+#define INPUT_RECORDER_HPP
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QObject>
+
+class QAction;
+class QWidget;
+
+/*
+ * Records what the user does in the planner windows, for InputReplayer.
+ * Set HOMEPLANNER_RECORD to a file name to record a session, it is
+ * written when the application quits.
+ *
+ * Recording starts with the first TemplateWindow or DesignWindow shown.
+ * From then on it keeps, with their time:
+ *
+ *  - key presses and releases
+ *  - mouse presses, releases, double clicks and drags, buttons included
+ *  - wheel turns
+ *  - menu actions and their shortcuts
+ *
+ * in the planner windows and the dialogs they open. Events are sent to
+ * the widget they first went to, named by its path from the window, so
+ * a replay works with windows of another size.
+ */
+class InputRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit InputRecorder(const QString &fileName, QObject *parent = nullptr);
+    ~InputRecorder() override;
+
+    bool save() const;
+
+    /* "TemplateWindow/PlanView#graphicsView/QWidget#qt_scrollarea_viewport".
+     * Widgets without a name are told apart by their place among siblings
+     * of the same class: "QPushButton[2]". */
+    static QString pathOf(const QWidget *widget);
+    /* The visible widget at a path, nullptr if there is none */
+    static QWidget *widgetAt(const QString &path);
+
+    static const int FormatVersion = 1;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void actionTriggered();
+
+private:
+    void start(QWidget *window);
+    void watchActions(QWidget *window);
+    bool isRecorded(const QWidget *widget) const;
+    void append(QJsonObject event, const QWidget *target);
+
+    QString m_fileName;
+    QString m_firstWindow;
+    QElapsedTimer m_clock;
+    QJsonArray m_events;
+
+    /* Parents see propagated events again, only the first one counts */
+    const QEvent *m_lastEvent;
+};
+
+#endif // INPUT_RECORDER_HPP
@@ -0,0 +1,74 @@
+#ifndef INPUT_REPLAYER_HPP
+#define INPUT_REPLAYER_HPP
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QObject>
+#include <QVector>
+
+class QJsonObject;
+
+/*
+ * Plays an InputRecorder session back into the planner windows and
+ * measures the frames the plan views paint meanwhile:
+ *
+ *   ./src -platform offscreen --replay session.json --report report.json
+ *
+ * Fast replay sends every event as soon as the one before it has been
+ * handled and its repaint is done, the run measures how long the planner
+ * takes for the session. Realtime replay keeps the recorded pace, the run
+ * measures what the user saw, frame rate included.
+ *
+ * Events go through QApplication like real input. Dialogs opened on the
+ * way are replayed inside their own event loop, nothing waits for them.
+ */
+class InputReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Pace { Fast, Realtime };
+
+    explicit InputReplayer(QObject *parent = nullptr);
+
+    bool load(const QString &fileName, QString *errorString = nullptr);
+
+    /* Class name of the window the session started in */
+    QString window() const;
+    int eventCount() const;
+
+    void start(Pace pace);
+
+    /* Summary printed to stdout and, in detail, saved as JSON */
+    QString summary() const;
+    bool saveReport(const QString &fileName) const;
+
+    /* Frames still being painted after the last event are counted */
+    static const int SettleDelay = 250;     // Milliseconds
+
+signals:
+    void finished();
+
+private slots:
+    void replayNext();
+    void framePainted(qint64 nsecs);
+    void finish();
+
+private:
+    void watchViews();
+    bool replay(const QJsonObject &event);
+
+    QString m_window;
+    QJsonArray m_events;
+    Pace m_pace;
+    int m_next;
+
+    QElapsedTimer m_clock;
+    qint64 m_wallTime;                      // Milliseconds
+
+    QVector<qint64> m_frameTimes;           // Nanoseconds
+    QVector<qint64> m_eventTimes;           // Nanoseconds
+    int m_missedTargets;
+};
+
+#endif // INPUT_REPLAYER_HPP
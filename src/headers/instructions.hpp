@@ -16,6 +16,9 @@ public:
     explicit Instructions(QWidget *parent = nullptr);
     ~Instructions();
 
+    /* Back to the first tab, for showing the window again */
+    void reset();
+
 private:
     Ui::Instructions *ui;
 };
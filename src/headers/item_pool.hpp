@@ -0,0 +1,58 @@
+#ifndef ITEM_POOL_HPP
+#define ITEM_POOL_HPP
+
+#include <cstddef>
+#include <QMutex>
+#include <QVector>
+
+/*
+ * Fixed size blocks for objects that are created and deleted by the
+ * thousand, like the furniture of a generated or imported plan. Blocks
+ * are carved out of chunks of BlocksPerChunk, so building a plan costs
+ * one allocation per chunk instead of one per item, and deleting it only
+ * puts the blocks back on a free list for the next plan.
+ *
+ * Chunks stay until trim() finds them empty, or the pool goes, so
+ * rebuilding a plan reuses them. Requests of another size, from
+ * classes derived from the pooled one, go to the global operator new.
+ * Thread safe: imports build items on a worker thread.
+ */
+class ItemPool
+{
+public:
+    explicit ItemPool(std::size_t blockSize);
+    ~ItemPool();
+
+    void *allocate(std::size_t size);
+    void deallocate(void *block, std::size_t size);
+    /* Frees the chunks without a block in use */
+    void trim();
+
+    struct Usage
+    {
+        int used = 0;           // Blocks handed out
+        int capacity = 0;       // Blocks in all chunks
+        qint64 bytes = 0;       // Chunks together
+    };
+    Usage usage() const;
+
+    static const int BlocksPerChunk = 256;
+
+private:
+    Q_DISABLE_COPY(ItemPool)
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    void addChunk();
+
+    mutable QMutex m_mutex;
+    std::size_t m_blockSize;
+    FreeBlock *m_free;
+    QVector<char*> m_chunks;
+    int m_used;
+};
+
+#endif // ITEM_POOL_HPP
@@ -0,0 +1,106 @@
+#ifndef JSON_INTERCHANGE_HPP
+#define JSON_INTERCHANGE_HPP
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QVector>
+
+#include "plan_record.hpp"
+
+/*
+ * JSON interchange format for other tools, see docs/json_format.md.
+ *
+ * Small files are parsed with QJsonDocument. Large ones go through
+ * JsonTokenizer, which reads the device in fixed-size blocks, so memory
+ * use does not grow with the file.
+ */
+namespace JsonInterchange {
+    const QString FormatName = "home-planner-2d";
+    const int Version = 1;
+
+    /* Files up to this size are simply parsed as a whole */
+    const qint64 DocumentLimit = 1024 * 1024;
+
+    QJsonObject toJson(const PlanRecord &record);
+    PlanRecord fromJson(const QJsonObject &object);
+
+    bool save(const QString &fileName, const QVector<PlanRecord> &records,
+              QString *errorString = nullptr);
+    bool load(const QString &fileName, QVector<PlanRecord> &records,
+              QString *errorString = nullptr);
+
+    /* Parses a whole document in memory */
+    bool readDocument(const QByteArray &json, QVector<PlanRecord> &records,
+                      QString *errorString = nullptr);
+}
+
+/* Writes one item at a time */
+class JsonPlanWriter
+{
+public:
+    explicit JsonPlanWriter(QIODevice *device);
+
+    void writeStart();
+    void writeRecord(const PlanRecord &record);
+    void writeEnd();
+
+private:
+    QIODevice *m_device;
+    bool m_first;
+};
+
+/* SAX-style tokenizer, ',' and ':' are consumed silently */
+class JsonTokenizer
+{
+public:
+    enum Token { Invalid, EndOfInput, BeginObject, EndObject, BeginArray, EndArray,
+                 String, Number, True, False, Null };
+
+    explicit JsonTokenizer(QIODevice *device);
+
+    Token next();
+    QString text() const;       // Value of the last String token
+    double number() const;      // Value of the last Number token
+    QString errorString() const;
+
+    static const int BlockSize = 64 * 1024;
+
+private:
+    bool fill();
+    int peek();
+    int get();
+    bool readString();
+    bool readNumber(char first);
+    bool readLiteral(const char *rest);
+
+    QIODevice *m_device;
+    QByteArray m_block;
+    int m_pos;
+    QString m_text;
+    double m_number;
+    QString m_error;
+};
+
+/* Pulls records out of a JSON stream one by one */
+class JsonPlanReader
+{
+public:
+    explicit JsonPlanReader(QIODevice *device);
+
+    bool readNext(PlanRecord &record);
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    bool findItems();
+    bool readRecord(PlanRecord &record);
+    bool skipValue(JsonTokenizer::Token token);
+    bool fail(const QString &message);
+
+    JsonTokenizer m_tokens;
+    enum { Start, InItems, Done } m_state;
+    QString m_error;
+};
+
+#endif // JSON_INTERCHANGE_HPP
@@ -18,6 +18,9 @@ public:
     explicit MainMenuWindow(QWidget *parent = nullptr);
     ~MainMenuWindow();
 
+    /* First page, as on start */
+    void reset();
+
 private slots:
     void on_btnCreateNew_clicked();
     void on_btnInstructions_clicked();
@@ -30,9 +33,6 @@ private slots:
 
 private:
     Ui::MainMenuWindow *ui;
-    TemplateWindow *tempWind;
-    DesignWindow *designWind;
-    Instructions *instructions;
 
     void setBackgroundImage();
 };
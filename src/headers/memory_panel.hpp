@@ -0,0 +1,41 @@
+#ifndef MEMORY_PANEL_HPP
+#define MEMORY_PANEL_HPP
+
+#include <QDialog>
+#include <QTimer>
+
+#include "memory_stats.hpp"
+
+class QLabel;
+class QTableWidget;
+
+/*
+ * Options > Memory Usage: live MemoryStats, refreshed every second, next
+ * to the last snapshot taken. Rows that grew since the snapshot are red.
+ *
+ * One panel for the whole application, it stays open while the user
+ * moves between windows.
+ */
+class MemoryPanel : public QDialog
+{
+    Q_OBJECT
+
+public:
+    static void showPanel();
+
+    static const int RefreshInterval = 1000;    // Milliseconds
+
+private slots:
+    void refresh();
+    void takeSnapshot();
+
+private:
+    explicit MemoryPanel(QWidget *parent = nullptr);
+
+    QTableWidget *m_table;
+    QLabel *m_windows;
+    QTimer m_timer;
+    MemoryStats::Snapshot m_snapshot;
+};
+
+#endif // MEMORY_PANEL_HPP
@@ -0,0 +1,59 @@
+#ifndef MEMORY_STATS_HPP
+#define MEMORY_STATS_HPP
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+/*
+ * What the planner holds in memory, counted from the objects themselves:
+ * rooms and furniture alive, ImageCache contents and the windows with
+ * their widgets. Take a snapshot, work for a while, take another and
+ * compare; kinds that keep growing while the plan stays the same leak.
+ *
+ * Bytes are what the counted objects hold directly: items and their
+ * model entries, pixel data of images and window backing stores. Qt's
+ * private data is not included, the numbers are a lower bound meant
+ * for comparing snapshots, not for matching the process size.
+ */
+class MemoryStats
+{
+public:
+    enum Kind { Rooms, Furniture, Pixmaps, Sprites, Brushes, Windows, Widgets, KindCount };
+
+    struct Entry
+    {
+        int count = 0;
+        qint64 bytes = 0;
+    };
+
+    struct Snapshot
+    {
+        qint64 time = 0;                        // Milliseconds since epoch
+        Entry entries[KindCount];
+        /* Top level windows by class name, hidden ones included */
+        QMap<QString, int> windowClasses;
+        int hiddenWindows = 0;
+
+        const Entry &operator[](Kind kind) const { return entries[kind]; }
+    };
+
+    static Snapshot take();
+
+    /* Gives back what deleted items left behind: assets nobody uses,
+     * images only the cache holds and empty furniture pool chunks. Call
+     * after freeing a plan, from the GUI thread. */
+    static void trim();
+
+    /* Kinds with more objects in after than in before, or more bytes
+     * beyond GrowthSlack */
+    static QVector<Kind> growth(const Snapshot &before, const Snapshot &after);
+
+    static QString kindName(Kind kind);
+    /* One line per kind, with the change since before when given */
+    static QString report(const Snapshot &snapshot, const Snapshot *before = nullptr);
+
+    static const qint64 GrowthSlack = 64 * 1024;
+};
+
+#endif // MEMORY_STATS_HPP
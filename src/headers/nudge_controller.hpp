@@ -0,0 +1,100 @@
+#ifndef NUDGE_CONTROLLER_HPP
+#define NUDGE_CONTROLLER_HPP
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointF>
+#include <QTimer>
+#include <QVector>
+
+class PlanScene;
+class QGraphicsItem;
+class QKeyEvent;
+
+/*
+ * Arrow key movement of the focused item. A tap moves by one step right
+ * away. A held key glides: after a short delay the item picks up
+ * speed, and the distance covered is applied once per display frame,
+ * however many auto-repeat events arrive in between. Each frame is one
+ * scene transaction, so there is a single repaint per frame.
+ *
+ * It also measures input latency, the time from a key event to the next
+ * painted frame. Set HOMEPLANNER_LATENCY to print the numbers on exit,
+ * HOMEPLANNER_LATENCY=immediate measures the old one move per key event
+ * behaviour for comparison.
+ */
+class NudgeController : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode { Immediate, Smooth };
+
+    struct Settings
+    {
+        qreal step = 1;             // Pixels per tap
+        qreal fastFactor = 5;       // Steps and speeds with Shift held
+        int holdDelay = 250;        // Milliseconds before a held key glides
+        qreal startSpeed = 60;      // Pixels per second when gliding starts
+        qreal acceleration = 400;   // Pixels per second, per second
+        qreal maxSpeed = 600;       // Pixels per second
+        int frameInterval = 16;     // Milliseconds
+    };
+
+    struct LatencyStats
+    {
+        int samples = 0;
+        double median = 0;      // Milliseconds
+        double p95 = 0;
+        double max = 0;
+    };
+
+    explicit NudgeController(PlanScene *scene);
+    ~NudgeController() override;
+
+    Settings settings() const;
+    void setSettings(const Settings &settings);
+    Mode mode() const;
+    void setMode(Mode mode);
+
+    /* Called by Room and Furniture. Return false for keys other than arrows. */
+    bool keyPressed(QGraphicsItem *item, QKeyEvent *event);
+    bool keyReleased(QKeyEvent *event);
+    void stop();
+
+    /* Called by PlanScene whenever a view paints it */
+    void framePainted();
+
+    LatencyStats latency() const;
+    void resetLatency();
+    QString latencyReport() const;
+
+private slots:
+    void tick();
+
+private:
+    static int keyBit(int key);
+    static QPointF direction(int keys);
+    bool isFast() const;
+    QVector<QGraphicsItem*> targets() const;
+
+    PlanScene *m_scene;
+    Settings m_settings;
+    Mode m_mode;
+
+    /* Gliding */
+    QTimer m_frameTimer;
+    QElapsedTimer m_heldTime;
+    QElapsedTimer m_frameClock;
+    int m_keys;             // Arrow keys held down, see keyBit()
+    qreal m_speed;
+    QPointF m_remainder;    // Movement below a whole pixel, kept for later
+
+    /* Latency */
+    QElapsedTimer m_probe;
+    bool m_probing;
+    QVector<double> m_samples;
+    bool m_reportOnExit;
+};
+
+#endif // NUDGE_CONTROLLER_HPP
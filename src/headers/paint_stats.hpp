@@ -0,0 +1,76 @@
+#ifndef PAINT_STATS_HPP
+#define PAINT_STATS_HPP
+
+#include <QtGlobal>
+
+/*
+ * Where the time of a frame goes, for the performance overlay of
+ * PlanView. Rooms, furniture and the image cache report into process
+ * wide counters, the view takes them out once per frame.
+ *
+ * Nothing is measured until a view turns the overlay on; off, every
+ * report is one relaxed atomic load.
+ */
+class PaintStats
+{
+public:
+    enum Kind {
+        RoomPaint,          // Room::paint, decoding included
+        FurniturePaint,     // Furniture::paint, decoding included
+        Decode,             // Images decoded or scaled by ImageCache
+        IndexQuery,         // Scene index lookup of the items to paint
+        KindCount
+    };
+
+    struct Frame
+    {
+        qint64 nsecs[KindCount] = {};
+        int counts[KindCount] = {};
+        int cacheHits = 0;
+        int cacheMisses = 0;
+    };
+
+    static bool isEnabled();
+    /* Counted, one user per overlay shown */
+    static void setEnabled(bool enabled);
+
+    /* Monotonic clock shared by all reports */
+    static qint64 now();
+
+    /* Start of a report, -1 when nothing is measured */
+    static qint64 begin(Kind kind);
+    static void add(Kind kind, qint64 nsecs);
+    static void cacheLookup(bool hit);
+
+    /* The view calls these around the scene's item lookup: the lookup
+     * runs after the background is drawn and before the first item */
+    static void indexQueryStarted();
+    static void indexQueryFinished();
+
+    /* Everything reported since the last call */
+    static Frame takeFrame();
+};
+
+/* Times the enclosing scope as one report of a kind */
+class PaintTimer
+{
+public:
+    explicit PaintTimer(PaintStats::Kind kind)
+        : m_kind(kind), m_start(PaintStats::begin(kind))
+    {
+    }
+
+    ~PaintTimer()
+    {
+        if (m_start >= 0)
+            PaintStats::add(m_kind, PaintStats::now() - m_start);
+    }
+
+private:
+    Q_DISABLE_COPY(PaintTimer)
+
+    PaintStats::Kind m_kind;
+    qint64 m_start;
+};
+
+#endif // PAINT_STATS_HPP
@@ -0,0 +1,49 @@
+#ifndef PLAN_ANALYSIS_HPP
+#define PLAN_ANALYSIS_HPP
+
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include "plan_record.hpp"
+
+/* Something wrong with a plan, ids refer to PlanRecord::id */
+struct PlanIssue
+{
+    enum Type { Overlap, OutsideRooms };
+
+    Type type;
+    quint64 first;
+    quint64 second;         // Only for Overlap, 0 otherwise
+};
+
+/* Everything PlanAnalysis found out about one plan */
+struct PlanReport
+{
+    int rooms = 0;
+    int furniture = 0;
+    double area = 0;                    // Sum of room areas, in m²
+    QMap<QString, int> categories;      // Furniture pieces per catalog category
+    QVector<PlanIssue> issues;
+
+    bool isValid() const;
+    QJsonObject toJson() const;
+};
+
+/*
+ * Geometry checks on plan records only, no scene or view is involved,
+ * so plans can be checked on any thread and without a display.
+ *
+ * Two rooms or two pieces of furniture overlap when their rotated
+ * rectangles share more than PlanGeometry::Tolerance pixels. Furniture
+ * is outside when one of its corners is not inside any room.
+ */
+namespace PlanAnalysis {
+    PlanReport analyze(const QVector<PlanRecord> &records);
+
+    /* Catalog directory of a furniture image, ":/img/furniture/beds/x.png" -> "beds" */
+    QString categoryOf(const QString &urlPath);
+}
+
+#endif // PLAN_ANALYSIS_HPP
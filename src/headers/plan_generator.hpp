@@ -0,0 +1,40 @@
+#ifndef PLAN_GENERATOR_HPP
+#define PLAN_GENERATOR_HPP
+
+#include <QString>
+#include <QVector>
+
+#include "plan_record.hpp"
+
+/*
+ * Made-up but plausible plans for load tests, benchmarks and demos.
+ *
+ * The floor is a rectangle cut into rooms again and again, so rooms
+ * share their walls and never overlap. Every room gets a purpose (living
+ * room, bedroom, office, ...), a matching floor texture, a door and
+ * furniture from the real catalog images, along its walls first. No
+ * piece overlaps another or sticks out of its room.
+ *
+ * The same options always give the same plan, on every platform, so a
+ * seed is all a benchmark needs to name its workload.
+ */
+namespace PlanGenerator {
+    enum Layout { Apartment, House, Office };
+
+    struct Options
+    {
+        Layout layout = Apartment;
+        int rooms = 5;
+        quint32 seed = 1;
+        qreal density = 1;          // Furniture per room, relative to a typical home
+    };
+
+    /* Rooms first, then furniture, ids are left 0 for the model to assign */
+    QVector<PlanRecord> generate(const Options &options);
+
+    /* "apartment", "house" or "office" */
+    bool layoutFromName(const QString &name, Layout *layout);
+    QString layoutName(Layout layout);
+}
+
+#endif // PLAN_GENERATOR_HPP
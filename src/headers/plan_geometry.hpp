@@ -0,0 +1,34 @@
+#ifndef PLAN_GEOMETRY_HPP
+#define PLAN_GEOMETRY_HPP
+
+#include <QPointF>
+#include <QRectF>
+
+#include "plan_record.hpp"
+
+/* Outlines of rotated plan items and the tests done on them.
+ * Items rotate around their center (see Room::rotate, Furniture::rotate). */
+namespace PlanGeometry {
+    /* 1 m is 33 px, everywhere in the planner */
+    const double PixelsPerMeter = 33;
+
+    /* Outlines closer than this do not count as overlapping,
+     * so rooms can share walls and furniture can stand against them */
+    const double Tolerance = 0.5;
+
+    /* Corners in scene coordinates, clockwise */
+    struct Quad
+    {
+        quint64 id;
+        QRectF bounds;
+        QPointF corners[4];
+    };
+
+    Quad quad(quint64 id, qreal x, qreal y, qreal width, qreal height, qreal angle);
+    Quad quad(const PlanRecord &record);
+
+    bool overlaps(const Quad &a, const Quad &b);
+    bool contains(const Quad &quad, const QPointF &point);
+}
+
+#endif // PLAN_GEOMETRY_HPP
@@ -0,0 +1,97 @@
+#ifndef PLAN_HISTORY_HPP
+#define PLAN_HISTORY_HPP
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QUndoStack>
+#include <QVector>
+
+#include "plan_op.hpp"
+#include "plan_scene.hpp"
+
+/* Everything one user action did to the plan. Records are sorted by id,
+ * before and after hold the same items at the same index. */
+struct PlanChange
+{
+    PlanOp::Type type = PlanOp::Add;
+    QVector<PlanRecord> before;
+    QVector<PlanRecord> after;
+    qint64 time = 0;        // Milliseconds since the history started
+
+    bool sameItems(const PlanChange &other) const;
+    qint64 memoryUsage() const;
+};
+
+/*
+ * Undo and redo for a PlanScene. The history listens to planChanged, so
+ * every way of editing the plan is recorded without the items knowing.
+ *
+ * Operations arriving in the same event loop pass (a moved selection,
+ * a cleared scene) become one entry. Moves and rotations of the same
+ * items merge with the previous entry while they keep coming, so holding
+ * an arrow key down is undone in one step.
+ *
+ * QUndoStack only limits the number of entries, the history also keeps
+ * an estimate of its memory and drops the oldest entries above a limit.
+ */
+class PlanHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PlanHistory(PlanScene *scene, QObject *parent = nullptr);
+
+    QUndoStack *stack();
+
+    /* Forgets every entry and takes the scene as it is now as the start */
+    void reset();
+
+    /* Changes made while not recording can not be undone, e.g. imports */
+    void setRecording(bool recording);
+    bool isRecording() const;
+
+    qint64 memoryUsage() const;
+    qint64 memoryLimit() const;
+    void setMemoryLimit(qint64 bytes);
+
+    /* Longest pause between two nudges that still merge, in milliseconds */
+    static const int MergeInterval = 1000;
+    static const qint64 DefaultMemoryLimit = 8 * 1024 * 1024;
+
+signals:
+    /* An undo or redo brought back an item that had been deleted */
+    void itemRestored(QGraphicsItem *item);
+
+private slots:
+    void record(const PlanOp &op);
+    void flush();
+
+private:
+    friend class PlanCommand;
+
+    void apply(const PlanChange &change, bool undo);
+    void restore(const PlanRecord &record);
+    void remove(quint64 id);
+    void trim();
+
+    PlanScene *m_scene;
+    QUndoStack m_stack;
+    QElapsedTimer m_clock;
+
+    /* Last known state of every item, the "before" of the next change */
+    QHash<quint64, PlanRecord> m_known;
+
+    /* Change being collected in this event loop pass */
+    QSharedPointer<PlanChange> m_pending;
+    QHash<quint64, int> m_pendingIndex;
+
+    qint64 m_memoryUsage;
+    qint64 m_memoryLimit;
+    bool m_recording;
+    bool m_applying;        // Changes coming from undo or redo
+    bool m_rebuilding;      // Trimming, nothing merges
+};
+
+#endif // PLAN_HISTORY_HPP
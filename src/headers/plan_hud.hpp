@@ -0,0 +1,50 @@
+#ifndef PLAN_HUD_HPP
+#define PLAN_HUD_HPP
+
+#include <QElapsedTimer>
+#include <QRect>
+#include <QVector>
+
+#include "paint_stats.hpp"
+
+class QPainter;
+
+/*
+ * Performance overlay of a PlanView. Keeps the last HistoryFrames frames
+ * and draws, in the top left corner of the view:
+ *
+ *  - frames per second, frame time and items painted
+ *  - paint time of rooms and furniture, image decoding, scene index
+ *    lookups and the image cache hit rate, averaged over the last second
+ *  - a histogram of frame times over the whole history
+ *
+ * Qt only paints when something changes, an idle view shows 0 fps.
+ */
+class PlanHud
+{
+public:
+    PlanHud();
+
+    void addFrame(qint64 nsecs, const PaintStats::Frame &stats);
+    void clear();
+
+    /* Part of a viewport of this size the overlay covers */
+    QRect rect(const QSize &viewport) const;
+    void draw(QPainter *painter, const QSize &viewport) const;
+
+    static const int HistoryFrames = 240;
+
+private:
+    struct Sample
+    {
+        qint64 time;        // When the frame ended
+        qint64 nsecs;       // Frame time
+        PaintStats::Frame stats;
+    };
+
+    QElapsedTimer m_clock;
+    QVector<Sample> m_samples;      // Ring buffer of HistoryFrames
+    int m_next;
+};
+
+#endif // PLAN_HUD_HPP
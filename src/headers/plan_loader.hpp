@@ -0,0 +1,17 @@
+#ifndef PLAN_LOADER_HPP
+#define PLAN_LOADER_HPP
+
+#include <QString>
+#include <QVector>
+
+#include "plan_record.hpp"
+
+/* Reads a whole plan in one go, whatever its format: project file (*.hp2d),
+ * bundle (*.hp2b) or JSON. Meant for tools that do not need progressive
+ * loading, the planner windows use ProjectImporter instead. */
+namespace PlanLoader {
+    bool load(const QString &fileName, QVector<PlanRecord> &records,
+              QString *errorString = nullptr);
+}
+
+#endif // PLAN_LOADER_HPP
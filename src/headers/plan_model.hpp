@@ -0,0 +1,89 @@
+#ifndef PLAN_MODEL_HPP
+#define PLAN_MODEL_HPP
+
+#include <QHash>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+#include "plan_record.hpp"
+
+/* Compact form of PlanRecord kept by PlanModel. Sizes, angles and
+ * stacking values fit in floats, images are shared through the model's
+ * image table, so one item takes 48 bytes and no allocation of its own. */
+struct PlanItem
+{
+    quint64 id = 0;
+    qreal x = 0;
+    qreal y = 0;
+    float width = 0;
+    float height = 0;
+    float angle = 0;
+    float zValue = 0;
+    quint32 image = 0;      // Index into the model's image table
+    PlanRecord::Kind kind = PlanRecord::FurnitureKind;
+    bool flipped = false;
+};
+Q_DECLARE_TYPEINFO(PlanItem, Q_MOVABLE_TYPE);
+
+/*
+ * The plan itself: rooms and furniture as values in one contiguous array,
+ * with transforms, area and collision queries. QtCore only, so it works
+ * in tools and benchmarks without a display.
+ *
+ * Room and Furniture are views over the model of the PlanScene they are
+ * in. Items outside of any PlanScene live in a per-thread detached model.
+ */
+class PlanModel
+{
+public:
+    PlanModel();
+
+    /* Items that are not in a PlanScene, one model per thread */
+    static PlanModel &detached();
+
+    /* Assigns a new id when record.id is 0, returns the id */
+    quint64 add(const PlanRecord &record);
+    bool remove(quint64 id);
+    void clear();
+    /* Hands the item over to another model, under the same id */
+    void moveTo(quint64 id, PlanModel &other);
+
+    bool contains(quint64 id) const;
+    int size() const;
+    int count(PlanRecord::Kind kind) const;
+
+    /* nullptr for unknown ids */
+    const PlanItem *item(quint64 id) const;
+    const QVector<PlanItem> &items() const;
+    QString image(const PlanItem &item) const;
+
+    PlanRecord record(quint64 id) const;
+    QVector<PlanRecord> records() const;
+
+    /* Transforms */
+    void setPosition(quint64 id, qreal x, qreal y);
+    void setAngle(quint64 id, qreal angle);
+    void setZValue(quint64 id, qreal zValue);
+    void setFlipped(quint64 id, bool flipped);
+    void setImage(quint64 id, const QString &urlPath);
+
+    /* Geometry, in scene coordinates with rotation included */
+    QRectF boundingRect(quint64 id) const;
+    double area(quint64 id) const;      // m²
+    double roomArea() const;            // m², all rooms together
+    QVector<quint64> itemsIn(const QRectF &rect) const;
+    /* Items of the same kind whose outline overlaps this one */
+    QVector<quint64> collisions(quint64 id) const;
+
+private:
+    PlanItem *find(quint64 id);
+    quint32 intern(const QString &urlPath);
+
+    QVector<PlanItem> m_items;
+    QHash<quint64, int> m_slots;        // Id -> index into m_items
+    QVector<QString> m_images;
+    QHash<QString, quint32> m_imageIds;
+};
+
+#endif // PLAN_MODEL_HPP
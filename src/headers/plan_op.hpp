@@ -0,0 +1,30 @@
+#ifndef PLAN_OP_HPP
+#define PLAN_OP_HPP
+
+#include <QDataStream>
+#include <QMap>
+#include <QMetaType>
+
+#include "plan_record.hpp"
+
+/* One change made to the plan. The record always holds the full state of
+ * the item after the change, but only the fields that matter for the
+ * operation type are written to disk. */
+struct PlanOp
+{
+    enum Type : quint8 { Add = 1, Move, Rotate, Flip, Delete, Floor };
+
+    Type type = Add;
+    PlanRecord record;
+
+    /* Applies the operation to a set of records keyed by id.
+     * Every operation stores absolute values, so applying it twice is harmless. */
+    void applyTo(QMap<quint64, PlanRecord> &records) const;
+};
+
+QDataStream &operator<<(QDataStream &out, const PlanOp &op);
+QDataStream &operator>>(QDataStream &in, PlanOp &op);
+
+Q_DECLARE_METATYPE(PlanOp)
+
+#endif // PLAN_OP_HPP
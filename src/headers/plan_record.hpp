@@ -0,0 +1,45 @@
+#ifndef PLAN_RECORD_HPP
+#define PLAN_RECORD_HPP
+
+#include <QDataStream>
+#include <QMetaType>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+/* Plain description of one scene item (room or furniture).
+ * This is what gets written to project files and handed between threads,
+ * so it must never hold QGraphicsItem pointers. */
+struct PlanRecord
+{
+    enum Kind : quint8 { RoomKind = 0, FurnitureKind = 1 };
+
+    quint64 id = 0;
+    Kind kind = FurnitureKind;
+    QString urlPath;        // Furniture image or floor texture
+    qreal x = 0;
+    qreal y = 0;
+    qreal width = 0;
+    qreal height = 0;
+    qreal angle = 0;        // Rotation around the item center, in degrees
+    qreal zValue = 0;
+    bool flipped = false;
+
+    /* Axis-aligned bounding rect in scene coordinates, rotation included */
+    QRectF sceneBoundingRect() const;
+
+    /* Unique item ids, shared by rooms and furniture */
+    static quint64 nextId();
+    static void reserveId(quint64 id);
+};
+
+bool operator==(const PlanRecord &a, const PlanRecord &b);
+bool operator!=(const PlanRecord &a, const PlanRecord &b);
+
+QDataStream &operator<<(QDataStream &out, const PlanRecord &record);
+QDataStream &operator>>(QDataStream &in, PlanRecord &record);
+
+Q_DECLARE_METATYPE(PlanRecord)
+Q_DECLARE_METATYPE(QVector<PlanRecord>)
+
+#endif // PLAN_RECORD_HPP
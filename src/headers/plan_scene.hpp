@@ -0,0 +1,124 @@
+#ifndef PLAN_SCENE_HPP
+#define PLAN_SCENE_HPP
+
+#include <QGraphicsScene>
+#include <QHash>
+#include <QImage>
+#include <QPair>
+#include <QSet>
+
+#include "nudge_controller.hpp"
+#include "plan_op.hpp"
+#include "plan_model.hpp"
+#include "plan_selection.hpp"
+
+/* Scene used by the planner windows. It owns the PlanModel its rooms and
+ * furniture are views of. They report their changes here, and the scene
+ * passes them on as planChanged signals. */
+class PlanScene : public QGraphicsScene
+{
+    Q_OBJECT
+
+public:
+    explicit PlanScene(QObject *parent = nullptr);
+    ~PlanScene() override;
+
+    PlanModel &model();
+    const PlanModel &model() const;
+
+    /* Selected rooms and furniture, without walking the scene */
+    const PlanSelection &selection() const;
+
+    /* Arrow key movement of the focused item */
+    NudgeController &nudge();
+
+    /* Draft frames are drawn while a view is dragged, panned or zoomed:
+     * items use small sprites and flat colors instead of full images */
+    enum RenderQuality { FullQuality, DraftQuality };
+    RenderQuality renderQuality() const;
+    void setRenderQuality(RenderQuality quality);
+
+    /* While furnishing, rooms can not be selected or moved. Checked by
+     * the rooms themselves, so switching costs nothing however big the
+     * plan is. */
+    void setRoomsLocked(bool locked);
+    bool roomsLocked() const;
+
+    /* Called by Room and Furniture */
+    void itemChanged(QGraphicsItem *item, PlanOp::Type type, const PlanRecord &record);
+    void itemSelectionChanged(QGraphicsItem *item, bool selected);
+
+    /* Room or furniture showing the item with this id, nullptr if there is none */
+    QGraphicsItem *item(quint64 id) const;
+
+    /* Finds the PlanScene an item lives in, nullptr if there is none */
+    static PlanScene *of(const QGraphicsItem *item);
+
+    /* Builds the room or furniture a record describes and adds it */
+    QGraphicsItem *addRecord(const PlanRecord &record);
+
+    /* Moves, rotates, flips and refloors the item with record.id until it
+     * matches the record. Returns false when there is no such item. */
+    bool updateItem(const PlanRecord &record);
+
+    /* Transactions: operations reported while one is open are held back,
+     * one per item and kind, and emitted together when the outermost
+     * transaction ends. Listeners then see a batch, not a stream. */
+    void beginTransaction();
+    void endTransaction();
+
+    /* One transform for many items, applied as a single transaction.
+     * Batches covering a large part of the scene drop the scene index
+     * and rebuild it once at the end instead of updating it item by item.
+     * Repaints are collected by the scene anyway, so the whole batch
+     * shows up in one frame. */
+    void moveItems(const QVector<QGraphicsItem*> &items, qreal dx, qreal dy);
+    /* Turns every item around its own center */
+    void rotateItems(const QVector<QGraphicsItem*> &items, qreal angle);
+    /* Turns the items as one block around the center of their bounds */
+    void rotateGroup(const QVector<QGraphicsItem*> &items, qreal angle);
+    void flipItems(const QVector<QGraphicsItem*> &items);
+
+    /* Rebuilding the index costs as much as the whole scene, updating it
+     * as much as the batch. Batches of at least IndexRebuildThreshold
+     * items and at least 1 / IndexRebuildFraction of the scene rebuild. */
+    static const int IndexRebuildThreshold = 128;
+    static const int IndexRebuildFraction = 4;
+
+    /* Draws every item onto a white image, cropped to the items.
+     * Works without any view, so it is safe in headless tools. */
+    QImage toImage(qreal scale = 1, int margin = 0);
+
+    /* Dirty tracking for incremental save */
+    void markDirty(quint64 id, QGraphicsItem *item);
+    void markRemoved(quint64 id);
+    bool hasChanges() const;
+    /* Hands out everything changed since the last call and marks it clean */
+    void takeChanges(QVector<PlanRecord> &changed, QVector<quint64> &removed);
+
+signals:
+    void planChanged(const PlanOp &op);
+
+protected:
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
+
+private:
+    bool suspendIndex(int itemCount);
+    bool rotate(QGraphicsItem *item, qreal angle);
+    void resumeIndex(bool suspended);
+
+    PlanModel m_model;
+    QHash<quint64, QGraphicsItem*> m_views;
+    PlanSelection m_selection;
+    NudgeController *m_nudge;
+    RenderQuality m_renderQuality;
+    bool m_roomsLocked;
+    QHash<quint64, QGraphicsItem*> m_dirtyItems;
+    QSet<quint64> m_removedIds;
+
+    int m_transactionDepth;
+    QVector<PlanOp> m_transactionOps;
+    QHash<QPair<quint64, int>, int> m_transactionIndex;     // (id, type) -> op
+};
+
+#endif // PLAN_SCENE_HPP
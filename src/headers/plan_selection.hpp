@@ -0,0 +1,86 @@
+#ifndef PLAN_SELECTION_HPP
+#define PLAN_SELECTION_HPP
+
+#include <QHash>
+#include <QVector>
+
+class QGraphicsItem;
+class Room;
+class Furniture;
+
+/* Items in selection order, with constant time insert and removal */
+template <typename T>
+class SelectionSet
+{
+public:
+    void insert(T *item)
+    {
+        if (m_index.contains(item))
+            return;
+        m_index.insert(item, m_items.size());
+        m_items.append(item);
+    }
+
+    /* The last item takes the place of the removed one */
+    void remove(T *item)
+    {
+        auto it = m_index.find(item);
+        if (it == m_index.end())
+            return;
+
+        const int index = *it;
+        m_index.erase(it);
+        T *last = m_items.takeLast();
+        if (last != item) {
+            m_items[index] = last;
+            m_index[last] = index;
+        }
+    }
+
+    void clear()
+    {
+        m_items.clear();
+        m_index.clear();
+    }
+
+    bool contains(T *item) const { return m_index.contains(item); }
+    int size() const { return m_items.size(); }
+    bool isEmpty() const { return m_items.isEmpty(); }
+    const QVector<T*> &items() const { return m_items; }
+
+private:
+    QVector<T*> m_items;
+    QHash<T*, int> m_index;
+};
+
+/*
+ * Selected rooms and furniture of a PlanScene, kept up to date one item
+ * at a time as items report selection changes, instead of walking the
+ * whole scene like QGraphicsScene::selectedItems() does on every call.
+ *
+ * Rooms and furniture are kept apart, so code working on one kind gets
+ * correctly typed pointers and never sees the other kind.
+ */
+class PlanSelection
+{
+public:
+    /* Called by PlanScene for every selection change and removed item */
+    void setSelected(QGraphicsItem *item, bool selected);
+    void remove(QGraphicsItem *item);
+    void clear();
+
+    bool isEmpty() const;
+    int size() const;
+    bool contains(const QGraphicsItem *item) const;
+
+    const QVector<Room*> &rooms() const;
+    const QVector<Furniture*> &furniture() const;
+    /* Rooms first, then furniture, for the PlanScene batch transforms */
+    QVector<QGraphicsItem*> items() const;
+
+private:
+    SelectionSet<Room> m_rooms;
+    SelectionSet<Furniture> m_furniture;
+};
+
+#endif // PLAN_SELECTION_HPP
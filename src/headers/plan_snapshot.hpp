@@ -0,0 +1,64 @@
+#ifndef PLAN_SNAPSHOT_HPP
+#define PLAN_SNAPSHOT_HPP
+
+#include <QSharedDataPointer>
+#include <QVector>
+
+#include "plan_record.hpp"
+
+struct SnapshotNode;
+
+/* What it takes to turn one snapshot into another */
+struct PlanDiff
+{
+    QVector<quint64> removed;
+    QVector<PlanRecord> added;
+    QVector<PlanRecord> changed;        // New state of items in both
+
+    bool isEmpty() const;
+};
+
+/*
+ * Persistent map from item id to record, for keeping many versions of a
+ * plan around. Records sit in a 32-way trie indexed by the id bits, whose
+ * nodes are implicitly shared:
+ *
+ *  - copying a snapshot copies one pointer,
+ *  - changing a copy duplicates only the few nodes on the way to the
+ *    changed record, every other node stays shared with the original,
+ *  - diff() skips every subtree the two snapshots share, so comparing
+ *    versions costs as much as their differences, not as the plan.
+ */
+class PlanSnapshot
+{
+public:
+    PlanSnapshot();
+    explicit PlanSnapshot(const QVector<PlanRecord> &records);
+    PlanSnapshot(const PlanSnapshot &other);
+    PlanSnapshot &operator=(const PlanSnapshot &other);
+    ~PlanSnapshot();
+
+    int size() const;
+    bool isEmpty() const;
+    bool contains(quint64 id) const;
+    /* nullptr for unknown ids, valid until the snapshot changes */
+    const PlanRecord *find(quint64 id) const;
+    /* In no particular order */
+    QVector<PlanRecord> records() const;
+
+    /* Adds or replaces the record with the same id */
+    void insert(const PlanRecord &record);
+    void remove(quint64 id);
+    void clear();
+
+    /* True when both hold the very same nodes, a copy nobody changed */
+    bool isSharedWith(const PlanSnapshot &other) const;
+
+    static PlanDiff diff(const PlanSnapshot &from, const PlanSnapshot &to);
+
+private:
+    QSharedDataPointer<SnapshotNode> m_root;
+    int m_size;
+};
+
+#endif // PLAN_SNAPSHOT_HPP
@@ -0,0 +1,66 @@
+#ifndef PLAN_VERSIONS_HPP
+#define PLAN_VERSIONS_HPP
+
+#include <QDateTime>
+#include <QObject>
+#include <QVector>
+
+#include "plan_op.hpp"
+#include "plan_scene.hpp"
+#include "plan_snapshot.hpp"
+
+/*
+ * Named versions of the plan in a PlanScene, for comparing designs
+ * ("with the corner sofa" against "without").
+ *
+ * The current plan is kept as a PlanSnapshot that follows planChanged.
+ * Saving a version copies that snapshot, which takes constant time, and
+ * all versions share every record they have in common. Switching only
+ * touches the items that differ between the scene and the version.
+ */
+class PlanVersions : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Version
+    {
+        QString name;
+        PlanSnapshot snapshot;
+        QDateTime created;
+    };
+
+    explicit PlanVersions(PlanScene *scene, QObject *parent = nullptr);
+
+    /* Takes the scene as it is now, after it was replaced as a whole */
+    void reset();
+    /* Drops every saved version as well, for a new plan */
+    void clear();
+
+    /* Returns the index of the new version */
+    int save(const QString &name);
+    bool switchTo(int index);
+    void remove(int index);
+
+    int count() const;
+    const Version &version(int index) const;
+    /* Version last saved or switched to, -1 if there is none */
+    int current() const;
+
+signals:
+    void versionsChanged();
+    /* Switching brought back an item the scene did not have */
+    void itemRestored(QGraphicsItem *item);
+
+private slots:
+    void record(const PlanOp &op);
+
+private:
+    PlanScene *m_scene;
+    PlanSnapshot m_state;
+    QVector<Version> m_versions;
+    int m_current;
+    bool m_applying;
+};
+
+#endif // PLAN_VERSIONS_HPP
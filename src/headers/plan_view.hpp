@@ -0,0 +1,110 @@
+#ifndef PLAN_VIEW_HPP
+#define PLAN_VIEW_HPP
+
+#include <QGraphicsView>
+#include <QPixmap>
+#include <QPointer>
+#include <QScopedPointer>
+#include <QTimer>
+#include <QVector>
+
+class PlanHud;
+
+/*
+ * View used by the planner windows for their PlanScene.
+ *
+ * Dragging items, panning and zooming switch it to draft quality: no
+ * antialiasing, no smooth pixmap scaling, and the scene's items draw
+ * cheap sprites. Once the view has been still for SettleDelay, one
+ * full quality frame is drawn.
+ *
+ * The mouse wheel and pinch gestures zoom smoothly around the cursor.
+ * While a zoom animates, frames are not drawn from the scene but scaled
+ * from a picture rendered once at the nearest zoom level (a power of
+ * the square root of two), with room around the visible part. The scene
+ * is drawn again, crisp, when the zoom comes to rest.
+ *
+ * The performance overlay, see PlanHud, shows where frame time goes.
+ */
+class PlanView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    explicit PlanView(QWidget *parent = nullptr);
+    ~PlanView() override;
+
+    void setAdaptiveQuality(bool adaptive);
+    bool adaptiveQuality() const;
+    bool isInteracting() const;
+
+    /* Animated zoom around the center of the view, or a point in it */
+    void zoomBy(qreal factor);
+    void zoomAt(qreal factor, const QPoint &viewportPos);
+    /* Scale of the view, rotation left out */
+    qreal zoom() const;
+
+    void setHudVisible(bool visible);
+    bool isHudVisible() const;
+
+    static const int SettleDelay = 150;     // Milliseconds
+
+signals:
+    /* Every frame drawn, with the time it took */
+    void framePainted(qint64 nsecs);
+
+protected:
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void wheelEvent(QWheelEvent *event) override;
+    bool viewportEvent(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void drawBackground(QPainter *painter, const QRectF &rect) override;
+
+private slots:
+    void settle();
+    void zoomStep();
+    void dropZoomCaches();
+    void refreshHud();
+
+private:
+    /* Called for every change of the picture caused by the user */
+    void interact();
+    void beginInteraction();
+    void endInteraction();
+    void setSceneQuality(bool draft);
+
+    /* A scene picture at one zoom level, in scene coordinates */
+    struct ZoomCache
+    {
+        int level;
+        QRectF sceneRect;
+        QPixmap pixmap;
+    };
+    const ZoomCache *zoomCache();
+
+    QTimer m_settleTimer;
+    QPainter::RenderHints m_fullHints;
+    bool m_adaptive;
+    bool m_interacting;
+    bool m_pressed;
+
+    /* Zoom animation */
+    QTimer m_zoomTimer;
+    qreal m_targetZoom;
+    QPoint m_anchorView;
+    QPointF m_anchorScene;
+    bool m_zooming;
+
+    QVector<ZoomCache> m_zoomCaches;
+    QPointer<QGraphicsScene> m_cachedScene;
+
+    /* Performance overlay, null while hidden */
+    QScopedPointer<PlanHud> m_hud;
+    QTimer m_hudTimer;
+    bool m_hudRefresh;      // The next frame only redraws the overlay
+};
+
+#endif // PLAN_VIEW_HPP
@@ -0,0 +1,39 @@
+#ifndef PROJECT_BUNDLE_HPP
+#define PROJECT_BUNDLE_HPP
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "plan_record.hpp"
+
+/*
+ * Shareable project bundle (*.hp2b):
+ *
+ *   quint32    magic  ('HP2B')
+ *   quint32    version
+ *   quint32    number of assets
+ *   per asset:
+ *       QByteArray SHA-1 of the original image file
+ *       QByteArray zlib-compressed image file
+ *   QByteArray zlib-compressed project file (see project_file.hpp)
+ *
+ * Every image that is not part of the application resources is stored
+ * once, records point to it with an "asset:<sha1>" url (see AssetStore).
+ */
+namespace ProjectBundle {
+    const quint32 Magic   = 0x48503242;     // 'HP2B'
+    const quint32 Version = 1;
+
+    bool isBundle(const QString &fileName);
+
+    bool save(const QString &fileName, const QVector<PlanRecord> &records,
+              QString *errorString = nullptr);
+
+    /* Registers the assets (still compressed) and returns the project file
+     * contents, ready for ProjectReader */
+    bool open(const QString &fileName, QByteArray &project,
+              QString *errorString = nullptr);
+}
+
+#endif // PROJECT_BUNDLE_HPP
@@ -0,0 +1,128 @@
+#ifndef PROJECT_FILE_HPP
+#define PROJECT_FILE_HPP
+
+#include <QDataStream>
+#include <QHash>
+#include <QIODevice>
+#include <QVector>
+
+#include "plan_record.hpp"
+
+/*
+ * Binary project format (*.hp2d):
+ *
+ *   quint32 magic  ('HP2D')
+ *   quint32 version
+ *   quint32 item count
+ *   qint64  offset of the chunk index
+ *   chunks, each one:
+ *       quint8  chunk type
+ *       quint32 number of records
+ *       records
+ *   chunk index:
+ *       quint32 number of chunks
+ *       qint64  offset of every live chunk, in stacking order
+ *
+ * Saving changes appends new copies of the touched chunks plus a new
+ * index, then patches the header. Old chunks stay in the file as dead
+ * bytes until the next full save.
+ *
+ * Version 1 files have no index offset in the header and no index, the
+ * chunks simply run to the end of the file. They are still read, and
+ * written back in version 2 the first time they are saved.
+ */
+namespace ProjectFile {
+    const quint32 Magic   = 0x48503244;     // 'HP2D'
+    const quint32 Version = 2;
+    const quint32 IndexVersion = 2;         // First version with a chunk index
+    const int ChunkSize   = 256;            // Records per chunk
+
+    enum ChunkType : quint8 { RecordChunk = 1 };
+}
+
+/* Where the records of an open project live in its file, so that a save
+ * only has to rewrite the chunks which contain changes */
+struct ProjectLayout
+{
+    QVector<qint64> chunkOffsets;           // -1 for chunks emptied by deletions
+    QVector<qint64> chunkBytes;
+    QVector<QVector<quint64>> chunkIds;
+    QHash<quint64, int> chunkOf;            // Record id -> chunk
+    qint64 deadBytes = 0;
+    bool converted = false;                 // Read from a version 1 file
+
+    void clear();
+    void setChunk(int chunk, qint64 offset, qint64 bytes, const QVector<quint64> &ids);
+    int itemCount() const;
+    qint64 liveBytes() const;
+
+    /* More garbage than data, or an old file, time for a full save */
+    bool needsCompaction() const;
+};
+
+Q_DECLARE_METATYPE(ProjectLayout)
+
+class ProjectWriter
+{
+public:
+    /* The device has to be seekable, the header is patched at the end */
+    explicit ProjectWriter(QIODevice *device);
+
+    void writeProject(const QVector<PlanRecord> &records, ProjectLayout *layout = nullptr);
+    bool hasError() const;
+
+    /* Writes a complete project file */
+    static bool save(const QString &fileName, const QVector<PlanRecord> &records,
+                     QString *errorString = nullptr, ProjectLayout *layout = nullptr);
+
+    /* Rewrites only the chunks containing changed or removed records,
+     * new records go into new chunks at the end */
+    static bool saveChanges(const QString &fileName, ProjectLayout &layout,
+                            const QVector<PlanRecord> &changed,
+                            const QVector<quint64> &removed,
+                            QString *errorString = nullptr);
+
+private:
+    qint64 writeChunk(const QVector<PlanRecord> &records);
+    void writeIndex(const ProjectLayout &layout, int itemCount);
+
+    QIODevice *m_device;
+    QDataStream m_out;
+};
+
+class ProjectReader
+{
+public:
+    explicit ProjectReader(QIODevice *device);
+
+    bool readHeader();
+    int itemCount() const;
+
+    /* Reads the next chunk into records, returns false at the end or on error */
+    bool readChunk(QVector<PlanRecord> &records);
+    /* Back to the first chunk, for reading the file once more */
+    bool rewind();
+
+    /* Chunks read so far */
+    const ProjectLayout &layout() const;
+
+    bool hasError() const;
+    QString errorString() const;
+
+    /* Reads a complete project file */
+    static bool load(const QString &fileName, QVector<PlanRecord> &records,
+                     QString *errorString = nullptr, ProjectLayout *layout = nullptr);
+
+private:
+    void indexChunks();
+
+    QIODevice *m_device;
+    QDataStream m_in;
+    int m_itemCount;
+    QVector<qint64> m_index;
+    int m_nextChunk;
+    ProjectLayout m_layout;
+    QString m_error;
+};
+
+#endif // PROJECT_FILE_HPP
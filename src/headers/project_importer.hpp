@@ -0,0 +1,72 @@
+#ifndef PROJECT_IMPORTER_HPP
+#define PROJECT_IMPORTER_HPP
+
+#include <atomic>
+#include <functional>
+#include <QObject>
+#include <QRectF>
+#include <QSemaphore>
+#include <QSharedPointer>
+
+#include "plan_record.hpp"
+#include "project_file.hpp"
+
+/* Shared by the GUI thread and the importer. Whichever side finishes
+ * first, the other one can still safely touch it. */
+class ImportControl
+{
+public:
+    ImportControl();
+
+    void cancel();
+    bool isCancelled() const;
+
+    /* GUI side: one batch has been put into the scene */
+    void batchConsumed();
+    /* Worker side: blocks until the GUI can take another batch */
+    bool waitForSlot();
+
+private:
+    QSemaphore m_slots;
+    std::atomic<bool> m_cancelled;
+};
+
+/*
+ * Reads a project file (binary, bundle or JSON) chunk by chunk on a worker thread and hands
+ * batches of item descriptions to the GUI thread.
+ * Items overlapping visibleRect are sent first, everything else in a
+ * second pass over the file, so nothing is held back in memory.
+ */
+class ProjectImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProjectImporter(QString fileName, QRectF visibleRect,
+                    QSharedPointer<ImportControl> control);
+
+    static const int BatchSize = 128;
+
+public slots:
+    void run();
+
+signals:
+    void started(int itemCount);
+    void batchReady(const QVector<PlanRecord> &batch);
+    /* Sent after the last batch, needed for incremental saving */
+    void layoutReady(const ProjectLayout &layout);
+    void finished(bool ok, const QString &errorString);
+
+private:
+    void readProject();
+    void readJson();
+    bool distribute(const std::function<bool(QVector<PlanRecord>&)> &readChunk,
+                    const std::function<bool()> &rewind);
+    bool send(QVector<PlanRecord> &batch);
+
+    QString m_fileName;
+    QRectF m_visibleRect;
+    QSharedPointer<ImportControl> m_control;
+};
+
+#endif // PROJECT_IMPORTER_HPP
@@ -1,13 +1,18 @@
 #ifndef ROOM_HPP
 #define ROOM_HPP
 
+#include <atomic>
 #include <QGraphicsItem>
-#include <QPen>
 
+#include "plan_op.hpp"
+#include "plan_model.hpp"
+
+/* View of a room kept by the PlanModel of its scene */
 class Room : public QGraphicsItem
 {
 public:
     Room(double width, double height, QString urlPath);
+    explicit Room(const PlanRecord &record);
     ~Room() override;
 
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
@@ -15,19 +20,36 @@ public:
 
     QRectF boundingRect() const override;
     void keyPressEvent(QKeyEvent *event) override;
+    void keyReleaseEvent(QKeyEvent *event) override;
+    void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
+
+    /* Needed so qgraphicsitem_cast can tell rooms from furniture */
+    enum { Type = UserType + 2 };
+    int type() const override;
+
+    quint64 id() const;
+    PlanRecord record() const;
+
+    /* Changed since the project was last saved */
+    bool isDirty() const;
+    void clearDirty();
 
     QString floorPath() const;
     void setFloorPath(QString urlP);
     void rotate(qreal angleParam);
     double getArea() const;
-    static int numberRooms;     // Room counter
+    static std::atomic<int> numberRooms;     // Room counter
 
 private:
-    qreal angle;
-    double m_width;
-    double m_height;
-    QPen m_pen;
-    QString m_urlPath;
+    const PlanItem &planItem() const;
+    void followScene();
+    void notifyScene(PlanOp::Type type);
+    void markDirty();
+
+    PlanModel *m_model;
+    quint64 m_id;
+    bool m_dirty;
 };
 
 #endif // ROOM_HPP
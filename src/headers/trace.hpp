@@ -0,0 +1,59 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <QtGlobal>
+
+/*
+ * Spans of work in Chrome trace-event format, for chrome://tracing and
+ * https://ui.perfetto.dev. Set HOMEPLANNER_TRACE to a file name to record:
+ *
+ *   HOMEPLANNER_TRACE=trace.json ./src
+ *
+ * Every thread fills its own buffer, the file is written when the
+ * process exits, or by Trace::write(). Unset, a span costs one load of
+ * a bool.
+ *
+ * Names and categories have to be string literals, only the pointers
+ * are kept until the file is written.
+ */
+class Trace
+{
+public:
+    static bool isEnabled() { return s_enabled; }
+
+    /* Microseconds since tracing started */
+    static double now();
+    static void addSpan(const char *name, const char *category, double start, double duration);
+
+    /* Writes everything recorded so far, returns false on errors.
+     * No other thread may be tracing meanwhile. */
+    static bool write();
+
+private:
+    static const bool s_enabled;
+};
+
+/* Records the enclosing scope as one span */
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name, const char *category = "plan")
+        : m_name(name), m_category(category), m_start(Trace::isEnabled() ? Trace::now() : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (m_start >= 0)
+            Trace::addSpan(m_name, m_category, m_start, Trace::now() - m_start);
+    }
+
+private:
+    Q_DISABLE_COPY(TraceSpan)
+
+    const char *m_name;
+    const char *m_category;
+    double m_start;
+};
+
+#endif // TRACE_HPP
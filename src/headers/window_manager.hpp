@@ -0,0 +1,85 @@
+#ifndef WINDOW_MANAGER_HPP
+#define WINDOW_MANAGER_HPP
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+class MainMenuWindow;
+class Instructions;
+class TemplateWindow;
+class DesignWindow;
+class PlanScene;
+
+/*
+ * Owns the planner's windows. Each kind is built on first use and only
+ * shown again afterwards, with its state reset: the furnishing window
+ * alone creates hundreds of widgets in setupUi, reopening it should not.
+ *
+ * Closing an editing window hides it and brings the main menu back.
+ * Hidden windows are freed once they have not been used for IdleTimeout,
+ * or right away when MemoryStats counts more than MemoryBudget bytes.
+ * All windows are deleted before the application quits.
+ *
+ * The furnishing window is built ahead of time, PrewarmDelay after the
+ * main menu is on screen, while the user is still choosing.
+ */
+class WindowManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static WindowManager *instance();
+
+    void showMainMenu();
+    void showInstructions();
+    void showDesign();
+    /* Furnishing stage, for this plan or the default apartment. The
+     * furnishing window takes ownership of plan. */
+    void showTemplate(PlanScene *plan = nullptr);
+
+    /* Closes every window, which ends the application */
+    void quit();
+    /* Frees every hidden window but the main menu, then what their
+     * plans leave behind, see MemoryStats::trim() */
+    void trim();
+
+    static const int IdleTimeout = 5 * 60 * 1000;      // Milliseconds
+    static const int IdleCheckInterval = 60 * 1000;    // Milliseconds
+    static const qint64 MemoryBudget = 256 * 1024 * 1024;
+    static const int PrewarmDelay = 500;               // Milliseconds
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void trimIdle();
+    void shutdown();
+    void prewarm();
+
+private:
+    explicit WindowManager(QObject *parent = nullptr);
+
+    template <class Window>
+    Window *window(QPointer<Window> &slot);
+    bool isEditingWindow(const QObject *object) const;
+    void windowHidden(QWidget *window);
+    void release(QWidget *window);
+
+    QPointer<MainMenuWindow> m_mainMenu;
+    QPointer<Instructions> m_instructions;
+    QPointer<DesignWindow> m_design;
+    QPointer<TemplateWindow> m_template;
+
+    /* Hidden windows and how long they have been */
+    QHash<QWidget*, QElapsedTimer> m_hidden;
+    QTimer m_idleTimer;
+    bool m_quitting;
+    bool m_prewarmScheduled;
+    /* Built by prewarm() and never shown yet */
+    bool m_templateFresh;
+};
+
+#endif // WINDOW_MANAGER_HPP
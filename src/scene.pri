@@ -0,0 +1,30 @@
+# Rooms, furniture and the plan scene, without any windows.
+# Needs QtWidgets for QGraphicsScene, but works on the offscreen platform.
+
+include($$PWD/core.pri)
+
+SOURCES += \
+        $$PWD/source/room.cpp \
+        $$PWD/source/furniture.cpp \
+        $$PWD/source/furniture_asset.cpp \
+        $$PWD/source/plan_scene.cpp \
+        $$PWD/source/plan_selection.cpp \
+        $$PWD/source/nudge_controller.cpp \
+        $$PWD/source/image_cache.cpp \
+        $$PWD/source/paint_stats.cpp \
+        $$PWD/source/default_plan.cpp \
+        $$PWD/source/memory_stats.cpp
+
+HEADERS += \
+        $$PWD/headers/room.hpp \
+        $$PWD/headers/furniture.hpp \
+        $$PWD/headers/furniture_asset.hpp \
+        $$PWD/headers/plan_scene.hpp \
+        $$PWD/headers/plan_selection.hpp \
+        $$PWD/headers/nudge_controller.hpp \
+        $$PWD/headers/image_cache.hpp \
+        $$PWD/headers/paint_stats.hpp \
+        $$PWD/headers/default_plan.hpp \
+        $$PWD/headers/memory_stats.hpp
+
+RESOURCES += $$PWD/resources.qrc
@@ -0,0 +1,58 @@
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "../headers/asset_store.hpp"
+
+static const QString AssetPrefix = "asset:";
+
+namespace {
+
+/* Shared by every window, guarded because bundles are opened on worker threads */
+struct AssetTable
+{
+    QMutex mutex;
+    QHash<QByteArray, QByteArray> compressed;
+};
+
+}
+
+static AssetTable &assetTable()
+{
+    static AssetTable table;
+    return table;
+}
+
+bool AssetStore::isAsset(const QString &urlPath)
+{
+    return urlPath.startsWith(AssetPrefix);
+}
+
+QString AssetStore::urlFor(const QByteArray &hash)
+{
+    return AssetPrefix + QString::fromLatin1(hash.toHex());
+}
+
+QByteArray AssetStore::hashOf(const QString &urlPath)
+{
+    return QByteArray::fromHex(urlPath.mid(AssetPrefix.size()).toLatin1());
+}
+
+QString AssetStore::add(const QByteArray &hash, const QByteArray &compressed)
+{
+    AssetTable &table = assetTable();
+    QMutexLocker locker(&table.mutex);
+
+    if (!table.compressed.contains(hash))
+        table.compressed.insert(hash, compressed);
+
+    return urlFor(hash);
+}
+
+QByteArray AssetStore::compressedData(const QString &urlPath)
+{
+    AssetTable &table = assetTable();
+    QMutexLocker locker(&table.mutex);
+
+    return table.compressed.value(hashOf(urlPath));
+}
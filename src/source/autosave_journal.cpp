@@ -0,0 +1,225 @@
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+
+#include "../headers/autosave_journal.hpp"
+#include "../headers/project_file.hpp"
+
+static QString snapshotPath(const QString &directory)
+{
+    return directory + "/snapshot.hp2d";
+}
+
+static QString journalPath(const QString &directory)
+{
+    return directory + "/journal.log";
+}
+
+AutosaveJournal::AutosaveJournal(QString directory, QObject *parent)
+    : QThread(parent), m_directory(directory),
+      m_lock(directory + "/autosave.lock"), m_locked(false),
+      m_stop(false), m_opsSinceSnapshot(0)
+{
+    QDir().mkpath(m_directory);
+
+    /* Only one window may own the journal at a time */
+    m_locked = m_lock.tryLock();
+}
+
+AutosaveJournal::~AutosaveJournal()
+{
+    stopThread();
+}
+
+QString AutosaveJournal::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+            + "/autosave";
+}
+
+bool AutosaveJournal::isAvailable() const
+{
+    return m_locked;
+}
+
+bool AutosaveJournal::hasRecoveryData() const
+{
+    if (!m_locked)
+        return false;
+
+    return QFileInfo(snapshotPath(m_directory)).size() > 0
+        || QFileInfo(journalPath(m_directory)).size() > 0;
+}
+
+QVector<PlanRecord> AutosaveJournal::recover() const
+{
+    QMap<quint64, PlanRecord> records;
+
+    QVector<PlanRecord> snapshot;
+    ProjectReader::load(snapshotPath(m_directory), snapshot);
+    for (const PlanRecord &record : snapshot)
+        records.insert(record.id, record);
+
+    QFile journal(journalPath(m_directory));
+    if (journal.open(QIODevice::ReadOnly)) {
+        QDataStream in(&journal);
+        in.setVersion(QDataStream::Qt_5_12);
+
+        /* A crash may have cut off the last operation, stop there */
+        while (!in.atEnd()) {
+            PlanOp op;
+            in >> op;
+            if (in.status() != QDataStream::Ok)
+                break;
+            op.applyTo(records);
+        }
+    }
+
+    return QVector<PlanRecord>::fromList(records.values());
+}
+
+void AutosaveJournal::startSession(const QVector<PlanRecord> &records)
+{
+    if (!m_locked)
+        return;
+
+    stopThread();
+
+    /* Only a shared copy here, the thread builds its state and writes the
+     * first snapshot. Until then the old files stay, a crash meanwhile
+     * offers the previous plan again rather than nothing. */
+    m_startRecords = records;
+    start(QThread::LowPriority);
+}
+
+void AutosaveJournal::discard()
+{
+    stopThread();
+
+    QFile::remove(snapshotPath(m_directory));
+    QFile::remove(journalPath(m_directory));
+}
+
+void AutosaveJournal::record(const PlanOp &op)
+{
+    if (!isRunning())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    m_pending.append(op);
+}
+
+void AutosaveJournal::stopThread()
+{
+    if (!isRunning())
+        return;
+
+    m_mutex.lock();
+    m_stop = true;
+    m_wake.wakeOne();
+    m_mutex.unlock();
+
+    wait();
+    m_stop = false;
+}
+
+void AutosaveJournal::run()
+{
+    /* The session starts from a snapshot of the plan it was given */
+    m_state.clear();
+    for (const PlanRecord &record : m_startRecords)
+        m_state.insert(record.id, record);
+    m_startRecords.clear();
+    compact();
+
+    QFile journal(journalPath(m_directory));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append))
+        return;
+
+    QVector<PlanOp> ops;
+    bool stop = false;
+
+    while (!stop) {
+        /* Collect whatever came in during the last interval */
+        m_mutex.lock();
+        if (!m_stop)
+            m_wake.wait(&m_mutex, FlushInterval);
+        ops.swap(m_pending);
+        stop = m_stop;
+        m_mutex.unlock();
+
+        if (ops.isEmpty())
+            continue;
+
+        const QVector<PlanOp> kept = foldOps(ops);
+        ops.clear();
+
+        QDataStream out(&journal);
+        out.setVersion(QDataStream::Qt_5_12);
+        for (const PlanOp &op : kept)
+            out << op;
+        journal.flush();
+
+        m_opsSinceSnapshot += kept.size();
+        if (m_opsSinceSnapshot >= CompactThreshold)
+            compact();
+    }
+}
+
+/* Folds the operations into the background copy of the plan.
+ * A drag produces a move for every mouse event, only the last move
+ * (or rotation) of an item within one batch is worth keeping. */
+QVector<PlanOp> AutosaveJournal::foldOps(const QVector<PlanOp> &ops)
+{
+    QSet<quint64> moved, rotated;
+    QVector<bool> keep(ops.size(), true);
+
+    for (int i = ops.size() - 1; i >= 0; i--) {
+        const PlanOp &op = ops.at(i);
+        QSet<quint64> *seen = op.type == PlanOp::Move   ? &moved
+                            : op.type == PlanOp::Rotate ? &rotated
+                                                        : nullptr;
+        if (!seen)
+            continue;
+
+        if (seen->contains(op.record.id))
+            keep[i] = false;
+        else
+            seen->insert(op.record.id);
+    }
+
+    QVector<PlanOp> kept;
+    kept.reserve(ops.size());
+    for (int i = 0; i < ops.size(); i++) {
+        if (keep.at(i)) {
+            ops.at(i).applyTo(m_state);
+            kept.append(ops.at(i));
+        }
+    }
+    return kept;
+}
+
+/* Writes the current plan as a snapshot, the journal can start over after this */
+void AutosaveJournal::compact()
+{
+    QSaveFile file(snapshotPath(m_directory));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QVector<PlanRecord> records = QVector<PlanRecord>::fromList(m_state.values());
+    ProjectWriter writer(&file);
+    writer.writeProject(records);
+
+    if (!writer.hasError() && file.commit()) {
+        m_opsSinceSnapshot = 0;
+
+        /* The snapshot already contains everything from the journal */
+        QFile journal(journalPath(m_directory));
+        if (journal.exists())
+            journal.resize(0);
+    }
+}
@@ -0,0 +1,59 @@
+#include "../headers/default_plan.hpp"
+#include "../headers/room.hpp"
+
+void DefaultPlan::apartment(QList<QGraphicsItem*> &rooms, QList<Furniture*> &doors)
+{
+    /* Living room with kitchen:  6.5 x 4  */
+    Room *living = new Room(6.5*33, 4*33, ":/img/furniture/floor/floor_light_3.jpg");
+    living->setPos(225, 150);
+    rooms.append(living);
+
+    /* Hallway:  3.5 x 1  */
+    Room *hallway = new Room(3.5*33, 1*33, ":/img/furniture/floor/tiles_light_grey.jpeg");
+    hallway->setPos(440, 249);
+    rooms.append(hallway);
+
+    /* Bedroom 1:  3.5 x 3  */
+    Room *bedroom1 = new Room(3.5*33, 3*33, ":/img/furniture/floor/floor_light_3.jpg");
+    bedroom1->setPos(523, 150);
+    rooms.append(bedroom1);
+
+    /* Bedroom 2:  2.5 x 4  */
+    Room *bedroom2 = new Room(2.5*33, 4*33, ":/img/furniture/floor/floor_light_3.jpg");
+    bedroom2->setPos(556, 249);
+    rooms.append(bedroom2);
+
+    /* Bathroom: 2.5 x 3 */
+    Room *bathroom = new Room(2.5*33, 3*33, ":/img/furniture/floor/tiles_white_1.jpg");
+    bathroom->setPos(440, 150);
+    rooms.append(bathroom);
+
+    /* ADDING DOORS */
+    /* Doors go into their own list. Added to the scene before the rooms,
+     * they would be drawn under them, so they are added last. */
+
+    /* Enter door */
+    Furniture *d0 = new Furniture(":/img/furniture/doors/doors_5.png", 20, 30);
+    d0->setPos(470, 259); d0->rotate(-90);
+    doors.append(d0);
+
+    /* Hallway-living room door */
+    Furniture *d1 = new Furniture(":/img/furniture/doors/doors_5.png", 20, 30);
+    d1->setPos(421.5, 251); d1->rotate(180);
+    doors.append(d1);
+
+    /* Hallway-bathroom door */
+    Furniture *d2 = new Furniture(":/img/furniture/doors/doors_6.png", 20, 30);
+    d2->setPos(447, 226.3); d2->rotate(-90);
+    doors.append(d2);
+
+    /* Hallway-bedroom1 door */
+    Furniture *d3 = new Furniture(":/img/furniture/doors/doors_3.png", 20, 30);
+    d3->setPos(529, 226.3); d3->rotate(-90);
+    doors.append(d3);
+
+    /* Hallway-bedroom2 door */
+    Furniture *d4 = new Furniture(":/img/furniture/doors/doors_3.png", 20, 30);
+    d4->setPos(553.5, 251);
+    doors.append(d4);
+}
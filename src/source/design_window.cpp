@@ -1,5 +1,6 @@
 #include <QApplication>
 #include <QDesktopWidget>
+#include <QFileDialog>
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QRegularExpression>
@@ -8,6 +9,9 @@
 #include "ui_design_window.h"
 #include "../headers/design_window.hpp"
 #include "../headers/room.hpp"
+#include "../headers/memory_panel.hpp"
+#include "../headers/memory_stats.hpp"
+#include "../headers/window_manager.hpp"
 
 DesignWindow::DesignWindow(QWidget *parent)
     : CenteredWindow(parent), ui(new Ui::DesignWindow)
@@ -16,17 +20,39 @@ DesignWindow::DesignWindow(QWidget *parent)
     setWindowCenter(1.25, 1.25);
     setWindowTitle("Home Planner 2D");
 
-    scene = new QGraphicsScene(this);
-    /* screenWidth and screenHeight are inherited from CenteredWindow */
-    scene->setSceneRect(0,0, screenWidth/1.5, screenHeight/1.5);
-    ui->graphicsView->setScene(scene);
+    createScene();
     ui->graphicsView->setRenderHint(QPainter::Antialiasing);
+    ui->graphicsView->setRenderHint(QPainter::SmoothPixmapTransform);
     ui->graphicsView->setDragMode(QGraphicsView::ScrollHandDrag);
 
     /* Initial 'zoom' */
     ui->graphicsView->scale(1.25, 1.25);
 }
 
+void DesignWindow::createScene()
+{
+    scene = new PlanScene(this);
+    /* screenWidth and screenHeight are inherited from CenteredWindow */
+    scene->setSceneRect(0,0, screenWidth/1.5, screenHeight/1.5);
+    ui->graphicsView->setScene(scene);
+}
+
+PlanScene *DesignWindow::takeScene()
+{
+    PlanScene *plan = scene;
+    plan->clearSelection();
+    plan->setParent(nullptr);
+    createScene();
+    return plan;
+}
+
+void DesignWindow::reset()
+{
+    scene->clear();
+    ui->graphicsView->resetTransform();
+    ui->graphicsView->scale(1.25, 1.25);
+}
+
 DesignWindow::~DesignWindow()
 {
     delete ui;
@@ -67,14 +93,11 @@ void DesignWindow::on_btnNext_clicked()
         "Are you sure you want to send this room scheme for furniture equipment?",
         QMessageBox::No | QMessageBox::Yes);
 
-    /* If the reply is yes, send data to TemplateWindow and hide DesignWindow */
+    /* If the reply is yes, hand the plan to TemplateWindow and hide DesignWindow */
     if (reply == QMessageBox::Yes) {
 
-        QList<QGraphicsItem*> itemList = ui->graphicsView->scene()->items(Qt::AscendingOrder);
-
-        tempWind = new TemplateWindow(this, itemList);
         DesignWindow::hide();
-        tempWind->show();
+        WindowManager::instance()->showTemplate(takeScene());
 
     } else {
         return;
@@ -85,88 +108,42 @@ void DesignWindow::on_btnNext_clicked()
 
 void DesignWindow::on_btnRotate_clicked()
 {
-    QList<QGraphicsItem*> selectedRooms = ui->graphicsView->scene()->selectedItems();
-    if (selectedRooms.isEmpty())
-        return;
-    else {
-        for (auto room : selectedRooms) {
-            Room *selectedRoom = qgraphicsitem_cast<Room*>(room);
-            selectedRoom->rotate(-90);
-        }
-    }
+    scene->rotateItems(scene->selection().items(), -90);
 }
 
 void DesignWindow::on_btnZoomOut_clicked() {
-    ui->graphicsView->scale(0.9, 0.9);
+    ui->graphicsView->zoomBy(0.9);
 }
 
 void DesignWindow::on_btnZoomIn_clicked() {
-    ui->graphicsView->scale(1.1, 1.1);
+    ui->graphicsView->zoomBy(1.1);
 }
 
 void DesignWindow::on_btnDelete_clicked()
 {
-    QList<QGraphicsItem*> selectedRooms = ui->graphicsView->scene()->selectedItems();
-    if (selectedRooms.isEmpty())
-        return;
-    else {
-        for (auto room : selectedRooms) {
-            Room *selectedRoom = qgraphicsitem_cast<Room*>(room);
-            delete selectedRoom;
-        }
-    }
+    /* Deleting shrinks the selection, so work on a copy */
+    const QVector<Room*> selected = scene->selection().rooms();
+    qDeleteAll(selected);
 }
 
 void DesignWindow::on_btnMoveUp_clicked()
 {
-    QList<QGraphicsItem*> selectedRooms = ui->graphicsView->scene()->selectedItems();
-    if (selectedRooms.isEmpty())
-        return;
-    else {
-        for (auto room : selectedRooms) {
-            Room *selectedRoom = qgraphicsitem_cast<Room*>(room);
-            selectedRoom->moveBy(0, -0.75); // Up
-        }
-    }
+    scene->moveItems(scene->selection().items(), 0, -0.75); // Up
 }
 
 void DesignWindow::on_btnMoveDown_clicked()
 {
-    QList<QGraphicsItem*> selectedRooms = ui->graphicsView->scene()->selectedItems();
-    if (selectedRooms.isEmpty())
-        return;
-    else {
-        for (auto room : selectedRooms) {
-            Room *selectedRoom = qgraphicsitem_cast<Room*>(room);
-            selectedRoom->moveBy(0, 0.75); // Down
-        }
-    }
+    scene->moveItems(scene->selection().items(), 0, 0.75); // Down
 }
 
 void DesignWindow::on_btnMoveRight_clicked()
 {
-    QList<QGraphicsItem*> selectedRooms = ui->graphicsView->scene()->selectedItems();
-    if (selectedRooms.isEmpty())
-        return;
-    else {
-        for (auto room : selectedRooms) {
-            Room *selectedRoom = qgraphicsitem_cast<Room*>(room);
-            selectedRoom->moveBy(0.75, 0); // Right
-        }
-    }
+    scene->moveItems(scene->selection().items(), 0.75, 0); // Right
 }
 
 void DesignWindow::on_btnMoveLeft_clicked()
 {
-    QList<QGraphicsItem*> selectedRooms = ui->graphicsView->scene()->selectedItems();
-    if (selectedRooms.isEmpty())
-        return;
-    else {
-        for (auto room : selectedRooms) {
-            Room *selectedRoom = qgraphicsitem_cast<Room*>(room);
-            selectedRoom->moveBy(-0.75, 0); // Left
-        }
-    }
+    scene->moveItems(scene->selection().items(), -0.75, 0); // Left
 }
 
 void DesignWindow::keyPressEvent(QKeyEvent *event)
@@ -219,8 +196,23 @@ void DesignWindow::keyPressEvent(QKeyEvent *event)
 
 /* Menu bar options */
 
+/* Any image file can be a floor, bundles carry it along when sharing */
+void DesignWindow::on_actionCustomFloor_triggered()
+{
+    if (scene->selection().rooms().isEmpty())
+        return;
+
+    QString fileName = QFileDialog::getOpenFileName(this, "Choose a floor texture",
+                "", "Images (*.png *.jpg *.jpeg *.bmp)");
+    if (fileName.isEmpty())
+        return;
+
+    setSelectedFloor(fileName);
+}
+
 void DesignWindow::on_actionClear_All_triggered() {
     ui->graphicsView->scene()->clear();
+    MemoryStats::trim();
 }
 
 void DesignWindow::on_actionShortcuts_triggered()
@@ -229,259 +221,119 @@ void DesignWindow::on_actionShortcuts_triggered()
         "SHORTCUT \t\t ACTION \n\n"
         "CTRL + H \t\t Opens this window \n"
         "CTRL + L \t\t Clears everything from the scene \n"
-        "CTRL + Q \t\t Quits HomePlanner2D \n\n"
+        "CTRL + Q \t\t Quits HomePlanner2D \n"
+        "F12 \t\t Performance overlay \n"
+        "SHIFT + F12 \t Memory usage \n\n"
 
-        "+/-"           "\t\t"  "Zoom in/out \n\n"
+        "+/-, wheel, pinch" "\t"  "Zoom in/out \n\n"
 
         "ROOMS (must be selected): \n"
         "R"        "\t\t"   "Rotate room(s) by 90 degrees \n"
-        "Arrows [SHIFT]" "\t"   "Move room(s) [by 10px] \n"
+        "Arrows [SHIFT]" "\t"   "Move focused room [by 5px], hold to glide \n"
         "DEL"           "\t\t"  "Delete room(s)"
     );
 }
 
 void DesignWindow::on_actionQuit_triggered() {
-    DesignWindow::close();
+    WindowManager::instance()->quit();
+}
+
+/* Frame times, see PlanHud */
+void DesignWindow::on_actionPerformanceOverlay_toggled(bool checked)
+{
+    ui->graphicsView->setHudVisible(checked);
+}
+
+void DesignWindow::on_actionMemoryUsage_triggered()
+{
+    MemoryPanel::showPanel();
 }
 
 /* FLOOR & TILES */
 
-void DesignWindow::on_btnTileWhite1_clicked()
+/* setFloorPath repaints the room itself */
+void DesignWindow::setSelectedFloor(const QString &urlPath)
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/tiles_white_1.jpg");
+    for (Room *room : scene->selection().rooms())
+        room->setFloorPath(urlPath);
+}
 
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+void DesignWindow::on_btnTileWhite1_clicked()
+{
+    setSelectedFloor(":/img/furniture/floor/tiles_white_1.jpg");
 }
 
 void DesignWindow::on_btnTileWhite3_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/tiles_white_3.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/tiles_white_3.jpg");
 }
 
 void DesignWindow::on_btnTileWhite2_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/tiles_white_2.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/tiles_white_2.jpg");
 }
 
 void DesignWindow::on_btnTileBeige_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/tiles_beige.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/tiles_beige.jpg");
 }
 
 void DesignWindow::on_btnTileLightGrey1_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/tiles_light_grey.jpeg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/tiles_light_grey.jpeg");
 }
 
 void DesignWindow::on_btnTileLightGrey2_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/tiles_lightgrey.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/tiles_lightgrey.jpg");
 }
 
 void DesignWindow::on_btnTileGrey_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/tiles_grey.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/tiles_grey.jpg");
 }
 
 void DesignWindow::on_btnFloorLight5_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_light_5.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_light_5.jpg");
 }
 
 void DesignWindow::on_btnFloorBeige_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_beige.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_beige.jpg");
 }
 
 void DesignWindow::on_btnFloorLight4_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_light_4.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_light_4.jpg");
 }
 
 void DesignWindow::on_btnFloorLight3_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_light_3.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_light_3.jpg");
 }
 
 void DesignWindow::on_btnFloorLight2_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_light_2.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_light_2.jpg");
 }
 
 void DesignWindow::on_btnFloorLight1_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_light_1.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_light_1.jpg");
 }
 
 void DesignWindow::on_btnFloorLight6_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_light_6.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_light_6.jpg");
 }
 
 void DesignWindow::on_btnFloorDark_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_dark.jpg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_dark.jpg");
 }
 
 void DesignWindow::on_btnFloorGrey_clicked()
 {
-    QList<QGraphicsItem*> selectedItems = ui->graphicsView->scene()->selectedItems();
-    if (selectedItems.isEmpty())
-        return;
-    else {
-        for (auto item : selectedItems) {
-            Room *r = qgraphicsitem_cast<Room*>(item);
-            r->setFloorPath(":/img/furniture/floor/floor_grey.jpeg");
-
-            r->update();    // Immediately call paint() which redraws the room with new floor texture
-        }
-    } // if-else
+    setSelectedFloor(":/img/furniture/floor/floor_grey.jpeg");
 }
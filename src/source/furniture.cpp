@@ -2,18 +2,58 @@
 #include <QApplication>
 #include <QDesktopWidget>
 #include <QGraphicsSceneMouseEvent>
+#include <QStyleOptionGraphicsItem>
 
 #include "../headers/furniture.hpp"
+#include "../headers/plan_scene.hpp"
+#include "../headers/image_cache.hpp"
+#include "../headers/paint_stats.hpp"
+#include "../headers/trace.hpp"
+
+/* Drawn around selected pieces */
+static const QPen SelectionOutline(Qt::green, 1);
+
+/* Describes a new piece of furniture, everything else about it is kept by the model */
+static PlanRecord furnitureRecord(const PlanRecord &record)
+{
+    PlanRecord furniture = record;
+    furniture.kind = PlanRecord::FurnitureKind;
+    /* A duplicate id (broken file) gets a fresh one instead of sharing data */
+    if (PlanModel::detached().contains(furniture.id))
+        furniture.id = 0;
+    return furniture;
+}
+
+static PlanRecord furnitureRecord(const QString &urlPath, int width, int height)
+{
+    PlanRecord furniture;
+    furniture.urlPath = urlPath;
+    furniture.width = width;
+    furniture.height = height;
+    return furnitureRecord(furniture);
+}
 
 Furniture::Furniture(QString urlPath, int width, int height, QGraphicsItem *parent)
-    : QGraphicsItem(parent), m_width(width), m_height(height), m_urlPath(urlPath)
+    : Furniture(FurnitureAsset::acquire(urlPath), width, height, parent)
 {
-    setFlags(ItemIsMovable | ItemIsFocusable | ItemIsSelectable);
+    /* acquire() counted this piece already */
+    m_asset->release();
+}
+
+Furniture::Furniture(const FurnitureAsset *asset, QGraphicsItem *parent)
+    : Furniture(asset, asset->catalogSize().width(), asset->catalogSize().height(), parent)
+{
+}
+
+Furniture::Furniture(const FurnitureAsset *asset, int width, int height, QGraphicsItem *parent)
+    : QGraphicsItem(parent), m_model(&PlanModel::detached()),
+      m_id(m_model->add(furnitureRecord(asset->urlPath(), width, height))),
+      m_asset(asset), m_dirty(false)
+{
+    m_asset->addUser();
+    setFlags(ItemIsMovable | ItemIsFocusable | ItemIsSelectable | ItemSendsGeometryChanges);
     setAcceptHoverEvents(true);
 
-    angle = 0;
-    zValue = 0;
-    m_isFlipped = false;
     numberFurniture++;
 
     /* Setting position to center of scene (screen) */
@@ -22,79 +62,152 @@ Furniture::Furniture(QString urlPath, int width, int height, QGraphicsItem *pare
     setPos(screenWidth/3, screenHeight/3);
 }
 
+/* Rebuilds a piece of furniture from a project file.
+ * No screen lookups here, so this is safe to call from any thread. */
+Furniture::Furniture(const PlanRecord &record, QGraphicsItem *parent)
+    : QGraphicsItem(parent), m_model(&PlanModel::detached()),
+      m_id(m_model->add(furnitureRecord(record))),
+      m_asset(FurnitureAsset::acquire(record.urlPath)), m_dirty(false)
+{
+    setFlags(ItemIsMovable | ItemIsFocusable | ItemIsSelectable | ItemSendsGeometryChanges);
+    setAcceptHoverEvents(true);
+
+    numberFurniture++;
+
+    /* The model already knows all of this, the item has to catch up */
+    setPos(record.x, record.y);
+    setZValue(record.zValue);
+    if (!qFuzzyIsNull(record.angle))
+        rotate(record.angle);
+}
+
 Furniture::~Furniture()
 {
+    notifyScene(PlanOp::Delete);
+    m_model->remove(m_id);
+    m_asset->release();
     numberFurniture--;
 //    QGraphicsItem::~QGraphicsItem();
 }
 
+/* Lives as long as the process: items can outlive every other static */
+static ItemPool &furniturePool()
+{
+    static ItemPool *pool = new ItemPool(sizeof(Furniture));
+    return *pool;
+}
+
+void *Furniture::operator new(std::size_t size)
+{
+    return furniturePool().allocate(size);
+}
+
+void Furniture::operator delete(void *block, std::size_t size)
+{
+    furniturePool().deallocate(block, size);
+}
+
+ItemPool::Usage Furniture::poolUsage()
+{
+    return furniturePool().usage();
+}
+
+void Furniture::trimPool()
+{
+    furniturePool().trim();
+}
+
 /* Necessary for QGraphicsItem casting (not needed) */
 int Furniture::type() const {
     return Type;
 }
 
 /* Initialization of a static variable */
-int Furniture::numberFurniture = 0;
+std::atomic<int> Furniture::numberFurniture(0);
+
+quint64 Furniture::id() const
+{
+    return m_id;
+}
+
+PlanRecord Furniture::record() const
+{
+    return m_model->record(m_id);
+}
+
+const FurnitureAsset *Furniture::asset() const
+{
+    return m_asset;
+}
+
+/* Geometry of this piece as the model has it */
+const PlanItem &Furniture::planItem() const
+{
+    static const PlanItem none;
+    const PlanItem *item = m_model->item(m_id);
+    return item ? *item : none;
+}
 
 void Furniture::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    Q_UNUSED(option); Q_UNUSED(widget);
+    Q_UNUSED(widget);
+    PaintTimer timer(PaintStats::FurniturePaint);
+    TraceSpan span("Furniture::paint", "paint");
 
     /* If furniture is selected, draw green outline around its boundingRect */
     if (isSelected()) {
-        painter->setPen(m_pen);
-        m_pen.setWidth(1);
-        m_pen.setColor(Qt::green);
+        painter->setPen(SelectionOutline);
         painter->drawRect(boundingRect());
     }
 
-    if (isFlipped())    // Draws a horizontally flipped image
-        painter->drawPixmap(0,0, m_width, m_height,
-                            QPixmap(m_urlPath).transformed(QTransform().scale(-1,1)));
-    else
-        painter->drawPixmap(0,0, m_width, m_height, QPixmap(m_urlPath));
+    const PlanItem &item = planItem();
+    const QRectF target(0,0, item.width, item.height);
+
+    if (item.flipped) {     // Draws a horizontally flipped image
+        painter->save();
+        painter->translate(item.width, 0);
+        painter->scale(-1, 1);
+    }
+
+    /* While the view moves, an image about as large as it shows on screen */
+    PlanScene *planScene = PlanScene::of(this);
+    const bool draft = planScene && planScene->renderQuality() == PlanScene::DraftQuality;
+    const int spriteSize = draft ? qCeil(qMax(item.width, item.height)
+            * option->levelOfDetailFromTransform(painter->worldTransform())) : 0;
+
+    /* Headless renderers paint on worker threads, where only QImage works */
+    if (ImageCache::isGuiThread()) {
+        const QPixmap pixmap = draft ? ImageCache::sprite(m_asset->urlPath(), spriteSize)
+                                     : m_asset->pixmap();
+        painter->drawPixmap(target, pixmap, pixmap.rect());
+    }
+    else {
+        const QImage image = draft ? ImageCache::spriteImage(m_asset->urlPath(), spriteSize)
+                                   : ImageCache::image(m_asset->urlPath());
+        painter->drawImage(target, image, image.rect());
+    }
+
+    if (item.flipped)
+        painter->restore();
 }
 
 QRectF Furniture::boundingRect() const {
-    return QRectF(0,0, m_width, m_height);
+    const PlanItem &item = planItem();
+    return QRectF(0,0, item.width, item.height);
 }
 
 void Furniture::keyPressEvent(QKeyEvent *event)
 {
-    /* Translation + SHIFT = 5px, else 1px */
+    /* Arrows move the focused item, see NudgeController */
+    PlanScene *planScene = PlanScene::of(this);
+    if (planScene && planScene->nudge().keyPressed(this, event))
+        return;
+
     bool shiftPressed = event->modifiers() & Qt::ShiftModifier;
 
+    /* Moving and rotating repaint by themselves, no update() needed */
     switch ( event->key() )
     {
-        /* Moving */
-        case Qt::Key_Right:
-            if (shiftPressed)
-                move(5, 0);
-            else
-                move(1, 0);
-            break;
-
-        case Qt::Key_Left:
-            if (shiftPressed)
-                move(-5, 0);
-            else
-                move(-1, 0);
-            break;
-
-        case Qt::Key_Up:
-            if (shiftPressed)
-                move(0, -5);
-            else
-                move(0, -1);
-            break;
-
-        case Qt::Key_Down:
-            if (shiftPressed)
-                move(0, 5);
-            else
-                move(0, 1);
-            break;
-
         /* Rotation + SHIFT = 90, else 5 */
         case Qt::Key_R:
             if (shiftPressed)
@@ -111,14 +224,20 @@ void Furniture::keyPressEvent(QKeyEvent *event)
 
         case Qt::Key_F:
             swapFlipped();
+            update();
             break;
 
         case Qt::Key_Delete:
             delete this;
             break;
     }
+}
 
-    this->update();
+void Furniture::keyReleaseEvent(QKeyEvent *event)
+{
+    PlanScene *planScene = PlanScene::of(this);
+    if (!planScene || !planScene->nudge().keyReleased(event))
+        QGraphicsItem::keyReleaseEvent(event);
 }
 
 /* We realized too late that this function is not necessary */
@@ -130,20 +249,21 @@ void Furniture::move(qreal x, qreal y)
 void Furniture::rotate(qreal angleParam)
 {
     /* Rotation origin point needs to be moved to the center of the object */
-    setTransformOriginPoint(m_width/2, m_height/2);
-    angle += angleParam;
-    setRotation(angle);
+    const PlanItem &item = planItem();
+    setTransformOriginPoint(item.width/2, item.height/2);
+    setRotation(rotation() + angleParam);
 }
 
 /* Never used, just for debugging */
 bool Furniture::isFlipped() const
 {
-    return m_isFlipped;
+    return planItem().flipped;
 }
 
 void Furniture::swapFlipped()
 {
-    m_isFlipped = !m_isFlipped;
+    m_model->setFlipped(m_id, !isFlipped());
+    notifyScene(PlanOp::Flip);
 }
 
 void Furniture::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -168,21 +288,114 @@ void Furniture::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
 
 void Furniture::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
 {
+    qreal depth = zValue();
+
     if (event->button() == Qt::LeftButton) {
-        zValue++;
+        depth++;
         /* Constraining maximum depth of z-buffer to 5 */
-        if (zValue > 5)
-            zValue = 5;
+        if (depth > 5)
+            depth = 5;
     }
 
     else if (event->button() == Qt::RightButton) {
-        zValue--;
+        depth--;
         /* This negative value check is needed because if there is a room in the scene,
          * going negative will draw furniture UNDER the room. Other solution is to set
          * zValue of rooms to -50 e.g. This is easier. */
-        if (zValue < 0)
-            zValue = 0;
+        if (depth < 0)
+            depth = 0;
+    }
+
+    this->setZValue(depth);
+}
+
+bool Furniture::isDirty() const
+{
+    return m_dirty;
+}
+
+void Furniture::clearDirty()
+{
+    m_dirty = false;
+}
+
+/* Registers the item with its scene once per save, not on every change */
+void Furniture::markDirty()
+{
+    PlanScene *planScene = PlanScene::of(this);
+    if (m_dirty || !planScene)
+        return;
+
+    m_dirty = true;
+    planScene->markDirty(m_id, this);
+}
+
+/* Moves the piece's data into the model of the scene it is now in */
+void Furniture::followScene()
+{
+    PlanScene *planScene = PlanScene::of(this);
+    PlanModel *target = planScene ? &planScene->model() : &PlanModel::detached();
+    if (target == m_model)
+        return;
+
+    PlanRecord r = m_model->record(m_id);
+    m_model->remove(m_id);
+    if (target->contains(r.id))
+        r.id = 0;
+    m_id = target->add(r);
+    m_model = target;
+}
+
+/* Reports changes to the plan scene, which passes them on to autosave */
+void Furniture::notifyScene(PlanOp::Type type)
+{
+    PlanScene *planScene = PlanScene::of(this);
+    if (!planScene)
+        return;
+
+    if (type == PlanOp::Delete) {
+        planScene->markRemoved(m_id);
+        m_dirty = false;
+    }
+    else {
+        markDirty();
+    }
+
+    planScene->itemChanged(this, type, record());
+}
+
+QVariant Furniture::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    switch (change)
+    {
+        case ItemPositionHasChanged:
+            m_model->setPosition(m_id, pos().x(), pos().y());
+            notifyScene(PlanOp::Move);
+            break;
+        case ItemRotationHasChanged:
+            m_model->setAngle(m_id, rotation());
+            notifyScene(PlanOp::Rotate);
+            break;
+        /* Leaving a scene counts as deletion there, entering one as adding */
+        case ItemSceneChange:
+            notifyScene(PlanOp::Delete);
+            break;
+        case ItemSceneHasChanged:
+            followScene();
+            notifyScene(PlanOp::Add);
+            break;
+        case ItemSelectedHasChanged:
+            if (PlanScene *planScene = PlanScene::of(this))
+                planScene->itemSelectionChanged(this, value.toBool());
+            break;
+        /* Stacking is saved too, but not journaled */
+        case ItemZValueHasChanged:
+            m_model->setZValue(m_id, zValue());
+            markDirty();
+            break;
+        default:
+            break;
     }
 
-    this->setZValue(zValue);
+    return QGraphicsItem::itemChange(change, value);
 }
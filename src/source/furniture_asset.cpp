@@ -0,0 +1,120 @@
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "../headers/furniture_asset.hpp"
+#include "../headers/image_cache.hpp"
+
+namespace {
+
+/* AssetStore has a table of its own, the name is kept apart from it */
+struct FurnitureAssetTable
+{
+    QMutex mutex;
+    QHash<QString, FurnitureAsset*> assets;
+};
+
+}
+
+static FurnitureAssetTable &assetTable()
+{
+    static FurnitureAssetTable table;
+    return table;
+}
+
+FurnitureAsset::FurnitureAsset(const QString &urlPath)
+    : m_urlPath(urlPath), m_decoded(0), m_users(0)
+{
+}
+
+/* Counted under the table lock, so trim() cannot free the asset between
+ * the lookup and the new user */
+const FurnitureAsset *FurnitureAsset::acquire(const QString &urlPath)
+{
+    FurnitureAssetTable &table = assetTable();
+    QMutexLocker locker(&table.mutex);
+
+    FurnitureAsset *&asset = table.assets[urlPath];
+    if (!asset)
+        asset = new FurnitureAsset(urlPath);
+    asset->m_users.ref();
+    return asset;
+}
+
+const FurnitureAsset *FurnitureAsset::define(const QString &urlPath, int width, int height)
+{
+    FurnitureAssetTable &table = assetTable();
+    QMutexLocker locker(&table.mutex);
+
+    FurnitureAsset *&asset = table.assets[urlPath];
+    if (!asset)
+        asset = new FurnitureAsset(urlPath);
+    asset->m_catalogSize = QSize(width, height);
+    return asset;
+}
+
+int FurnitureAsset::count()
+{
+    FurnitureAssetTable &table = assetTable();
+    QMutexLocker locker(&table.mutex);
+    return table.assets.size();
+}
+
+/* The caller's own use keeps the asset alive meanwhile */
+void FurnitureAsset::addUser() const
+{
+    m_users.ref();
+}
+
+/* Freeing is left to trim(), pieces come and go by the thousand */
+void FurnitureAsset::release() const
+{
+    m_users.deref();
+}
+
+void FurnitureAsset::trim()
+{
+    FurnitureAssetTable &table = assetTable();
+    QMutexLocker locker(&table.mutex);
+
+    for (auto it = table.assets.begin(); it != table.assets.end(); ) {
+        FurnitureAsset *asset = *it;
+        if (asset->m_users.load() > 0) {
+            ++it;
+        }
+        else if (asset->m_catalogSize.isEmpty()) {
+            delete asset;
+            it = table.assets.erase(it);
+        }
+        else {
+            asset->m_pixmap = QPixmap();
+            asset->m_decoded.store(0);
+            ++it;
+        }
+    }
+}
+
+const QString &FurnitureAsset::urlPath() const
+{
+    return m_urlPath;
+}
+
+QSize FurnitureAsset::catalogSize() const
+{
+    return m_catalogSize;
+}
+
+const QPixmap &FurnitureAsset::pixmap() const
+{
+    if (m_decoded.loadAcquire())
+        return m_pixmap;
+
+    /* ImageCache keeps the pixel data, the asset only holds on to it */
+    FurnitureAssetTable &table = assetTable();
+    QMutexLocker locker(&table.mutex);
+    if (!m_decoded.load()) {
+        m_pixmap = ImageCache::pixmap(m_urlPath);
+        m_decoded.storeRelease(1);
+    }
+    return m_pixmap;
+}
@@ -0,0 +1,365 @@
+#include <QAbstractButton>
+#include <QHash>
+
+#include "ui_furniture_catalog.h"
+#include "../headers/furniture_catalog.hpp"
+
+struct CatalogEntry
+{
+    const char *button;
+    const char *urlPath;
+    int width;
+    int height;
+};
+
+/* Image and size in pixels of the piece every button adds */
+static const CatalogEntry Catalog[] = {
+    /* SOFAS - category 1 */
+    { "btnSofa1_Black", ":/img/furniture/sofas/sofa_1_black.png", 50, 30 },
+    { "btnSofa1_White", ":/img/furniture/sofas/sofa_1_white.png", 50, 30 },
+    { "btnSofa1_Blue", ":/img/furniture/sofas/sofa_1_light_blue.png", 50, 30 },
+    { "btnSofa1_Purple", ":/img/furniture/sofas/sofa_1_purple.png", 50, 30 },
+    { "btnSofa1_Red", ":/img/furniture/sofas/sofa_1_red.png", 50, 30 },
+    { "btnSofa1_Beige", ":/img/furniture/sofas/sofa_1_light_brown.png", 50, 30 },
+    { "btnSofa1_Green", ":/img/furniture/sofas/sofa_1_green.png", 50, 30 },
+
+    /* SOFAS - category 2 */
+    { "btnSofa2_Grey", ":/img/furniture/sofas/sofa_2_grey.png", 50, 30 },
+    { "btnSofa2_White", ":/img/furniture/sofas/sofa_2_white.png", 50, 30 },
+    { "btnSofa2_Red", ":/img/furniture/sofas/sofa_2_red.png", 50, 30 },
+    { "btnSofa2_Yellow", ":/img/furniture/sofas/sofa_2_yellow.png", 50, 30 },
+
+    /* CORNER SOFAS - category 1 */
+    { "btnCornerSofa1_Black", ":/img/furniture/sofas/corner_sofa_1_black.png", 60, 50 },
+    { "btnCornerSofa1_Beige", ":/img/furniture/sofas/corner_sofa_1_light.png", 60, 50 },
+    { "btnCornerSofa1_White", ":/img/furniture/sofas/corner_sofa_1_white.png", 60, 50 },
+    { "btnCornerSofa1_Brown", ":/img/furniture/sofas/corner_sofa_1_brown.png", 60, 50 },
+    { "btnCornerSofa1_Red", ":/img/furniture/sofas/corner_sofa_1_red.png", 60, 50 },
+    { "btnCornerSofa1_Purple", ":/img/furniture/sofas/corner_sofa_1_purple.png", 60, 50 },
+    { "btnCornerSofa1_Blue", ":/img/furniture/sofas/corner_sofa_1_blue.png", 60, 50 },
+    { "btnCornerSofa1_Skyblue", ":/img/furniture/sofas/corner_sofa_1_skyblue.png", 60, 50 },
+    { "btnCornerSofa1_Green", ":/img/furniture/sofas/corner_sofa_1_green.png", 60, 50 },
+
+    /* CORNER SOFAS - category 2 */
+    { "btnCornerSofa2_Beige", ":/img/furniture/sofas/corner_sofa_2_yellow.png", 90, 55 },
+    { "btnCornerSofa2_Purple", ":/img/furniture/sofas/corner_sofa_2_purple.png", 90, 55 },
+    { "btnCornerSofa2_Blue", ":/img/furniture/sofas/corner_sofa_2_blue.png", 90, 55 },
+
+    /* CORNER SOFAS - category 3 */
+    { "btnCornerSofa3_Black", ":/img/furniture/sofas/corner_sofa_3_black.png", 90, 55 },
+    { "btnCornerSofa3_White", ":/img/furniture/sofas/corner_sofa_3_white.png", 90, 55 },
+    { "btnCornerSofa3_Beige", ":/img/furniture/sofas/corner_sofa_3_beige.png", 90, 55 },
+    { "btnCornerSofa3_Red", ":/img/furniture/sofas/corner_sofa_3_red.png", 90, 55 },
+    { "btnCornerSofa3_Purple", ":/img/furniture/sofas/corner_sofa_3_purple.png", 90, 55 },
+    { "btnCornerSofa3_Blue", ":/img/furniture/sofas/corner_sofa_3_blue.png", 90, 55 },
+
+    /* CORNER SOFAS - category 4 */
+    { "btnCornerSofa4_Black", ":/img/furniture/sofas/corner_sofa_4_black.png", 65, 55 },
+    { "btnCornerSofa4_White", ":/img/furniture/sofas/corner_sofa_4_white.png", 65, 55 },
+
+    /* BENCHES */
+    { "btnBenchBamboo", ":/img/furniture/sofas/sofa_3_bamboo.png", 45, 25 },
+    { "btnBenchWooden_Light", ":/img/furniture/sofas/sofa_3_wooden_light.png", 45, 25 },
+    { "btnBenchWooden_Dark", ":/img/furniture/sofas/sofa_3_wooden_dark.png", 45, 25 },
+
+    /* ARMCHAIRS - category 1 */
+    { "btnArmchair1_black", ":/img/furniture/armchairs/armchair_1_black.png", 25, 25 },
+    { "btnArmchair1_white", ":/img/furniture/armchairs/armchair_1_white.png", 25, 25 },
+    { "btnArmchair1_green", ":/img/furniture/armchairs/armchair_1_green.png", 25, 25 },
+    { "btnArmchair1_blue", ":/img/furniture/armchairs/armchair_1_blue.png", 25, 25 },
+    { "btnArmchair1_orange", ":/img/furniture/armchairs/armchair_1_orange.png", 25, 25 },
+    { "btnArmchair1_red", ":/img/furniture/armchairs/armchair_1_red.png", 25, 25 },
+
+    /* ARMCHAIRS - category 2 */
+    { "btnArmchair2_lightgrey", ":/img/furniture/armchairs/armchair_2_lightgrey.png", 20, 23 },
+    { "btnArmchair2_lightgreen", ":/img/furniture/armchairs/armchair_2_lightgreen.png", 20, 23 },
+
+    /* ARMCHAIRS - category 3 */
+    { "btnArmchair3_black", ":/img/furniture/armchairs/armchair_3_black.png", 25, 25 },
+    { "btnArmchair3_red", ":/img/furniture/armchairs/armchair_3_red.png", 25, 25 },
+    { "btnArmchair3_purple", ":/img/furniture/armchairs/armchair_3_purple.png", 25, 25 },
+    { "btnArmchair3_blue", ":/img/furniture/armchairs/armchair_3_blue.png", 25, 25 },
+    { "btnArmchair3_green", ":/img/furniture/armchairs/armchair_3_green.png", 25, 25 },
+
+    /* ARMCHAIRS - category 4 */
+    { "btnArmchair4_purple", ":/img/furniture/armchairs/armchair_4_purple.png", 22, 25 },
+    { "btnArmchair4_blue", ":/img/furniture/armchairs/armchair_4_blue.png", 22, 25 },
+
+    /* TABOURETS */
+    { "btnTabouret_black", ":/img/furniture/armchairs/tabouret_black.png", 15, 15 },
+    { "btnTabouret_brown", ":/img/furniture/armchairs/tabouret_brown.png", 15, 15 },
+    { "btnTabouret_white", ":/img/furniture/armchairs/tabouret_grey.png", 15, 15 },
+    { "btnTabouret_blue", ":/img/furniture/armchairs/tabouret_blue.png", 15, 15 },
+
+    /* TABLES - category 1 (dining) */
+    { "btnTable1_dark", ":/img/furniture/tables/table_1_dark.png", 50, 25 },
+    { "btnTable1_grey", ":/img/furniture/tables/table_1_grey.png", 50, 25 },
+    { "btnTable1_light", ":/img/furniture/tables/table_1_light.png", 50, 25 },
+    { "btnTable1_white", ":/img/furniture/tables/table_1_white.png", 50, 25 },
+
+    /* TABLES - category 2 (coffee) */
+    { "btnTable2_darkblue", ":/img/furniture/tables/table_2_darkblue.png", 25, 25 },
+    { "btnTable2_dark", ":/img/furniture/tables/table_2_dark.png", 25, 25 },
+    { "btnTable2_light", ":/img/furniture/tables/table_2_light.png", 25, 25 },
+    { "btnTable2_grey", ":/img/furniture/tables/table_2_grey.png", 25, 25 },
+    { "btnTable2_white", ":/img/furniture/tables/table_2_white.png", 25, 25 },
+
+    /* TABLES - category 3 (round) */
+    { "btnTable3_dark", ":/img/furniture/tables/table_3_round_dark_wood.png", 25, 25 },
+    { "btnTable3_light", ":/img/furniture/tables/table_3_round_light_wood.png", 25, 25 },
+
+    /* TABLES - category 4 (planks) */
+    { "btnTable4_dark", ":/img/furniture/tables/table_4_dark_wood.png", 40, 25 },
+    { "btnTable4_light", ":/img/furniture/tables/table_4_light_wood.png", 40, 25 },
+
+    /* TABLES - category 5 (set 1) */
+    { "btnTable5_dark", ":/img/furniture/tables/table_5_complete_dark.png", 50, 50 },
+    { "btnTable5_blue", ":/img/furniture/tables/table_5_complete_blue.png", 50, 50 },
+    { "btnTable5_brown", ":/img/furniture/tables/table_5_complete_brown.png", 50, 50 },
+
+    /* TABLES - category 6 (set 2) */
+    { "btnTable6_dark", ":/img/furniture/tables/table_6_dark.png", 45, 35 },
+    { "btnTable6_light", ":/img/furniture/tables/table_6_light.png", 45, 35 },
+
+    /* TABLES - category 7 (semi-rounded) */
+    { "btnTable7_dark", ":/img/furniture/tables/table_7_dark.png", 50, 30 },
+    { "btnTable7_light", ":/img/furniture/tables/table_7_light.png", 50, 30 },
+
+    /* TABLES - category 8 (glass) */
+    { "btnTableGlass", ":/img/furniture/tables/glass_table.png", 35, 20 },
+
+    /* TABLES - category 9 (TV stands) */
+    { "btnTVStand_brown", ":/img/furniture/tables/tv_stand_table_1_brown.png", 55, 13 },
+    { "btnTVStand_darkgrey", ":/img/furniture/tables/tv_stand_table_1_darkgrey.png", 55, 13 },
+    { "btnTVStand_lightgrey", ":/img/furniture/tables/tv_stand_table_1_lightgrey.png", 55, 13 },
+    { "btnTVStand_dark", ":/img/furniture/tables/tv_stand_table_2_dark.png", 55, 15 },
+
+    /* CHAIRS - category 1 (computer) */
+    { "btnChair1_black", ":/img/furniture/chairs/chair_1_black.png", 20, 20 },
+    { "btnChair1_grey", ":/img/furniture/chairs/chair_1_grey.png", 20, 20 },
+    { "btnChair1_blue", ":/img/furniture/chairs/chair_1_blue.png", 20, 20 },
+    { "btnChair1_red", ":/img/furniture/chairs/chair_1_red.png", 20, 20 },
+    { "btnChair1_yellow", ":/img/furniture/chairs/chair_1_yellow.png", 20, 20 },
+
+    /* CHAIRS - category 2 (normal) */
+    { "btnChair2_light", ":/img/furniture/chairs/chair_2_light.png", 15, 18 },
+    { "btnChair2_dark", ":/img/furniture/chairs/chair_2_dark.png", 15, 18 },
+
+    /* CHAIRS - category 3 (normal) */
+    { "btnChair3_dark", ":/img/furniture/chairs/chair_3_dark.png", 15, 18 },
+    { "btnChair3_light", ":/img/furniture/chairs/chair_3_light.png", 15, 18 },
+
+    /* CHAIRS - category 4 (stools) */
+    { "btnStool_brown", ":/img/furniture/chairs/stool_brown.png", 15, 15 },
+    { "btnStool_light", ":/img/furniture/chairs/stool_light_brown.png", 15, 15 },
+
+    /* CABINETS - category 1 */
+    { "btnCabinet1_brown", ":/img/furniture/wardrobes & cabinets/cabinet_1_brown.png", 23, 18 },
+    { "btnCabinet1_light", ":/img/furniture/wardrobes & cabinets/cabinet_1_light.png", 23, 18 },
+    { "btnCabinet1_white", ":/img/furniture/wardrobes & cabinets/cabinet_1_white.png", 23, 18 },
+
+    /* CABINETS - category 2 */
+    { "btnCabinet2_dark", ":/img/furniture/wardrobes & cabinets/cabinet_2_dark_brown.png", 20, 16 },
+    { "btnCabinet2_brown", ":/img/furniture/wardrobes & cabinets/cabinet_2_brown.png", 20, 16 },
+
+    /* CABINETS - category 3 */
+    { "btnCabinet3_dark", ":/img/furniture/wardrobes & cabinets/cabinet_3_dark.png", 17, 17 },
+    { "btnCabinet3_light", ":/img/furniture/wardrobes & cabinets/cabinet_3_light.png", 17, 17 },
+
+    /* CABINETS - category 4 (night tables) */
+    { "btnNightTable_darkblue", ":/img/furniture/wardrobes & cabinets/night_table_1_darkblue.png", 20, 15 },
+    { "btnNightTable_normal", ":/img/furniture/wardrobes & cabinets/night_table_1_normal.png", 20, 15 },
+    { "btnNightTable_white", ":/img/furniture/wardrobes & cabinets/night_table_1_white.png", 20, 15 },
+
+    /* WARDROBES - category 1 */
+    { "btnWardrobe1_black", ":/img/furniture/wardrobes & cabinets/wardrobe_1_black.png", 45, 20 },
+    { "btnWardrobe1_grey", ":/img/furniture/wardrobes & cabinets/wardrobe_1_grey.png", 45, 20 },
+    { "btnWardrobe1_white", ":/img/furniture/wardrobes & cabinets/wardrobe_1_white.png", 45, 20 },
+    { "btnWardrobe1_brown", ":/img/furniture/wardrobes & cabinets/wardrobe_1_brown.png", 45, 20 },
+    { "btnWardrobe1_normal", ":/img/furniture/wardrobes & cabinets/wardrobe_1_normal.png", 45, 20 },
+    { "btnWardrobe1_light", ":/img/furniture/wardrobes & cabinets/wardrobe_1_light.png", 45, 20 },
+
+    /* WARDROBES - category 2 */
+    { "btnWardrobe2_black", ":/img/furniture/wardrobes & cabinets/wardrobe_2_black.png", 50, 20 },
+    { "btnWardrobe2_grey", ":/img/furniture/wardrobes & cabinets/wardrobe_2_grey.png", 50, 20 },
+    { "btnWardrobe2_white", ":/img/furniture/wardrobes & cabinets/wardrobe_2_white.png", 50, 20 },
+    { "btnWardrobe2_dark", ":/img/furniture/wardrobes & cabinets/wardrobe_2_dark.png", 50, 20 },
+    { "btnWardrobe2_normal", ":/img/furniture/wardrobes & cabinets/wardrobe_2_normal.png", 50, 20 },
+    { "btnWardrobe2_light", ":/img/furniture/wardrobes & cabinets/wardrobe_2_light.png", 50, 20 },
+
+    /* WARDROBES - category 3 */
+    { "btnWardrobe3", ":/img/furniture/wardrobes & cabinets/wardrobe_3.png", 50, 20 },
+
+    /* KITCHEN EQUIPMENT */
+    { "btnBottomCabinet1", ":/img/furniture/kitchen/bottom_cabinet_1.png", 45, 45 },
+    { "btnBottomCabinet2", ":/img/furniture/kitchen/bottom_cabinet_2.png", 30, 24 },
+    { "btnBottomCabinet3", ":/img/furniture/kitchen/bottom_cabinet_3.png", 15, 23 },
+    { "btnTopCabinet1", ":/img/furniture/kitchen/top_cabinet_1.png", 45, 45 },
+    { "btnTopCabinet2", ":/img/furniture/kitchen/top_cabinet_2.png", 30, 17 },
+    { "btnTopCabinet3", ":/img/furniture/kitchen/top_cabinet_3.png", 15, 17 },
+    { "btnStove", ":/img/furniture/kitchen/stove.png", 24, 24 },
+
+    /* SINKS */
+    { "btnSink1", ":/img/furniture/sinks/sink_1.png", 15, 15 },
+    { "btnSink2", ":/img/furniture/sinks/sink_2.png", 20, 15 },
+    { "btnSink3", ":/img/furniture/sinks/sink_3.png", 35, 15 },
+    { "btnSink4", ":/img/furniture/sinks/sink_4.png", 35, 15 },
+    { "btnSink5", ":/img/furniture/sinks/sink_5.png", 25, 17 },
+    { "btnSink6", ":/img/furniture/sinks/sink_6.png", 24, 16 },
+
+    /* BEDS - category 1 (baby cot) */
+    { "btnBabyBed_blue", ":/img/furniture/beds/baby_bed_lightblue.png", 27, 18 },
+    { "btnBabyBed_yellow", ":/img/furniture/beds/baby_bed_lightyellow.png", 27, 18 },
+
+    /* BEDS - category 2 (single beds 1) */
+    { "btnSingleBed1_blue", ":/img/furniture/beds/single_bed_lightblue.png", 40, 25 },
+    { "btnSingleBed1_yellow", ":/img/furniture/beds/single_bed_lightyellow.png", 40, 25 },
+    { "btnSingleBed1_white", ":/img/furniture/beds/single_bed_white.png", 40, 25 },
+
+    /* BEDS - category 3 (single beds 2) */
+    { "btnSingleBed2_blue", ":/img/furniture/beds/single_bed_2_blue.png", 55, 25 },
+    { "btnSingleBed2_green", ":/img/furniture/beds/single_bed_2_green.png", 55, 25 },
+    { "btnSingleBed2_purple", ":/img/furniture/beds/single_bed_2_purple.png", 55, 25 },
+
+    /* BEDS - category 4 (king beds 1) */
+    { "btnKingBed1_lightblue", ":/img/furniture/beds/king_bed_1_lightblue.png", 38, 50 },
+    { "btnKingBed1_lightred", ":/img/furniture/beds/king_bed_1_lightred.png", 38, 50 },
+    { "btnKingBed1_white", ":/img/furniture/beds/king_bed_1_white.png", 38, 50 },
+
+    /* BEDS - category 5 (king beds 2) */
+    { "btnKingBed2_lightred", ":/img/furniture/beds/king_bed_2_lightred.png", 42, 50 },
+    { "btnKingBed2_white", ":/img/furniture/beds/king_bed_2_white.png", 42, 50 },
+
+    /* ED - category 1 (fridges, washing machines, refrigerator, vent, microwave) */
+    { "btnFridge_dark", ":/img/furniture/electronic devices/fridge_dark.png", 25, 25 },
+    { "btnFridge_light", ":/img/furniture/electronic devices/fridge_white.png", 25, 25 },
+    { "btnRefrigerator", ":/img/furniture/electronic devices/refridgerator.png", 30, 25 },
+    { "btnVent", ":/img/furniture/electronic devices/vent.png", 30, 20 },
+    { "btnAirConditioner", ":/img/furniture/electronic devices/air_conditioner.png", 30, 10 },
+    { "btnWashingMachine_grey", ":/img/furniture/electronic devices/washing_machine_grey.png", 25, 20 },
+    { "btnWashingMachine_white", ":/img/furniture/electronic devices/washing_machine_white.png", 25, 20 },
+    { "btnMicrowave", ":/img/furniture/electronic devices/microwave.png", 17, 10 },
+
+    /* ED - TV, laptops and PC */
+    { "btnTV1_black", ":/img/furniture/electronic devices/tv_1_black.png", 33, 7 },
+    { "btnTV1_white", ":/img/furniture/electronic devices/tv_1_white.png", 33, 7 },
+    { "btnTV2_black", ":/img/furniture/electronic devices/tv_2_black.png", 33, 5 },
+    { "btnTV2_white", ":/img/furniture/electronic devices/tv_2_white.png", 33, 5 },
+    { "btnLaptopMac", ":/img/furniture/electronic devices/laptop_mac.png", 13, 8 },
+    { "btnLaptop_black", ":/img/furniture/electronic devices/laptop_black.png", 13, 8 },
+    { "btnLaptop_white", ":/img/furniture/electronic devices/laptop_white.png", 13, 8 },
+    { "btnPC", ":/img/furniture/electronic devices/pc.png", 22, 12 },
+
+    /* ED - speakers */
+    { "btnSpeakers1_black", ":/img/furniture/electronic devices/speakers_1_black.png", 23, 10 },
+    { "btnSpeakers1_brown", ":/img/furniture/electronic devices/speakers_1_brown.png", 23, 10 },
+    { "btnSpeakers2_black", ":/img/furniture/electronic devices/speakers_2_black.png", 10, 10 },
+    { "btnSpeakers2_brown", ":/img/furniture/electronic devices/speakers_2_brown.png", 10, 10 },
+
+    /* BATHS - category 1 (corner, round, shower) */
+    { "btnBath1_dark", ":/img/furniture/bathroom/bath_1_dark.png", 30, 30 },
+    { "btnBath1_light", ":/img/furniture/bathroom/bath_1_light.png", 30, 30 },
+    { "btnBath1_white", ":/img/furniture/bathroom/bath_1_white.png", 30, 30 },
+    { "btnBath2", ":/img/furniture/bathroom/bath_2.png", 40, 25 },
+    { "btnShower", ":/img/furniture/bathroom/shower_1.png", 30, 25 },
+
+    /* BATHROOM - category 2 (other) */
+    { "btnBathroomCabinet", ":/img/furniture/bathroom/cabinet.png", 15, 15 },
+    { "btnBathSink1", ":/img/furniture/bathroom/sink_1.png", 20, 15 },
+    { "btnBathSink2", ":/img/furniture/bathroom/sink_2.png", 18, 13 },
+
+    /* BATH - category 3 (toilets) */
+    { "btnToilet1", ":/img/furniture/bathroom/toilet_1.png", 12, 20 },
+    { "btnToilet2_white", ":/img/furniture/bathroom/toilet_2_white.png", 12, 15 },
+    { "btnToilet2_grey", ":/img/furniture/bathroom/toilet_2_grey.png", 12, 15 },
+
+    /* DOORS */
+    { "btnDoor1", ":/img/furniture/doors/doors_1.png", 20, 30 },
+    { "btnDoor2", ":/img/furniture/doors/doors_2.png", 20, 30 },
+    { "btnDoor3", ":/img/furniture/doors/doors_3.png", 20, 30 },
+    { "btnDoor4", ":/img/furniture/doors/doors_4.png", 20, 30 },
+    { "btnDoor5", ":/img/furniture/doors/doors_5.png", 20, 30 },
+    { "btnDoor6", ":/img/furniture/doors/doors_6.png", 20, 30 },
+
+    /* CARPETS - category 1 (round) */
+    { "btnCarpet1_dark", ":/img/furniture/other/carpet_1_dark.png", 35, 35 },
+    { "btnCarpet1_brown", ":/img/furniture/other/carpet_1_brown.png", 35, 35 },
+    { "btnCarpet1_blue", ":/img/furniture/other/carpet_1_blue.png", 35, 35 },
+    { "btnCarpet1_purple", ":/img/furniture/other/carpet_1_purple.png", 35, 35 },
+
+    /* CARPETS - category 2 (square) */
+    { "btnCarpet2Col2", ":/img/furniture/other/carpet_2_colorful_2.png", 40, 30 },
+    { "btnCarpet2Col1", ":/img/furniture/other/carpet_2_colorful_1.png", 40, 30 },
+    { "btnCarpet2Col3", ":/img/furniture/other/carpet_2_colorful_3.png", 40, 30 },
+
+    /* PIANOS */
+    { "btnPiano_black", ":/img/furniture/other/piano_black.png", 30, 10 },
+    { "btnPiano_brown", ":/img/furniture/other/piano_brown.png", 30, 10 },
+
+    /* EXERCISE */
+    { "btnBenchPress", ":/img/furniture/other/bench_press.png", 27, 30 },
+    { "btnExerciseBike", ":/img/furniture/other/exercise_bicycle.png", 12, 25 },
+
+    /* PLANTS */
+    { "btnChristmasTree", ":/img/furniture/other/christmas_tree.png", 22, 22 },
+    { "btnPlant", ":/img/furniture/other/plant.png", 18, 18 },
+
+    /* SHELVES */
+    { "btnShelf_dark", ":/img/furniture/other/shelf_dark.png", 50, 7 },
+    { "btnShelf_light", ":/img/furniture/other/shelf_light.png", 50, 7 },
+    { "btnShelf_grey", ":/img/furniture/other/shelf_grey.png", 50, 7 },
+    { "btnShelf_white", ":/img/furniture/other/shelf_white.png", 50, 7 },
+
+    /* LAMPS */
+    { "btnLamp1", ":/img/furniture/other/lamp_1.png", 12, 12 },
+    { "btnLamp2", ":/img/furniture/other/lamp_2.png", 11, 11 },
+    { "btnLamp3", ":/img/furniture/other/lamp_3.png", 7, 9 },
+
+    /* OTHER */
+    { "btnIroning_white", ":/img/furniture/other/ironing_board_white.png", 40, 13 },
+    { "btnIroning_lightblue", ":/img/furniture/other/ironing_board_lightblue.png", 40, 13 },
+    { "btnBin", ":/img/furniture/other/bin.png", 17, 14 },
+    { "btnFireplace", ":/img/furniture/other/fireplace.png", 45, 20 },
+    { "btnBooks", ":/img/furniture/other/books.png", 7, 6 },
+    { "btnBowl", ":/img/furniture/other/fruit_bowl.png", 9, 9 },
+    { "btnDuckie", ":/img/furniture/other/rubber_duck.png", 3, 5 },
+    { "btnCat", ":/img/furniture/other/cat.png", 8, 13 },
+};
+
+static const QHash<QString, const CatalogEntry*> &catalogIndex()
+{
+    static QHash<QString, const CatalogEntry*> index;
+    if (index.isEmpty())
+        for (const CatalogEntry &entry : Catalog)
+            index.insert(entry.button, &entry);
+    return index;
+}
+
+FurnitureCatalog::FurnitureCatalog(QWidget *parent)
+    : QWidget(parent), ui(new Ui::FurnitureCatalog)
+{
+    ui->setupUi(this);
+    reset();
+
+    const QHash<QString, const CatalogEntry*> &index = catalogIndex();
+    for (QAbstractButton *button : findChildren<QAbstractButton*>()) {
+        const CatalogEntry *entry = index.value(button->objectName());
+        if (!entry)
+            continue;
+        const FurnitureAsset *asset = FurnitureAsset::define(entry->urlPath, entry->width, entry->height);
+        connect(button, &QAbstractButton::clicked, this, [this, asset]() {
+            emit furnitureChosen(asset);
+        });
+    }
+}
+
+FurnitureCatalog::~FurnitureCatalog()
+{
+    delete ui;
+}
+
+void FurnitureCatalog::reset()
+{
+    /* Always start with the first catalog tab opened */
+    ui->toolBox->setCurrentIndex(0);
+}
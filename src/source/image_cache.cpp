@@ -0,0 +1,217 @@
+#include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QThread>
+
+#include "../headers/image_cache.hpp"
+#include "../headers/asset_store.hpp"
+#include "../headers/paint_stats.hpp"
+
+typedef QPair<QString, int> SpriteKey;
+
+struct ImageTable
+{
+    QMutex mutex;
+    /* GUI thread */
+    QHash<QString, QPixmap> pixmaps;
+    QHash<SpriteKey, QPixmap> sprites;
+    /* Worker threads */
+    QHash<QString, QImage> images;
+    QHash<SpriteKey, QImage> spriteImages;
+    /* Any thread */
+    QHash<QString, QColor> colors;
+    QHash<QString, QBrush> brushes;
+};
+
+/* Sprites never get smaller than this, nor larger than the image */
+static const int MinSpriteSize = 8;
+
+/* Floor textures are tiled at this size, whatever the image's own size */
+static const int FloorTileSize = 35;
+
+static ImageTable &imageTable()
+{
+    static ImageTable table;
+    return table;
+}
+
+/* Looks key up, or makes the value with the lock released and inserts it.
+ * Should another thread have been quicker, its value wins. */
+template <class Key, class Value, class Make>
+static Value cached(QHash<Key, Value> &hash, const Key &key, Make make)
+{
+    ImageTable &table = imageTable();
+    {
+        QMutexLocker locker(&table.mutex);
+        auto it = hash.constFind(key);
+        PaintStats::cacheLookup(it != hash.constEnd());
+        if (it != hash.constEnd())
+            return *it;
+    }
+
+    const Value value = make();
+
+    QMutexLocker locker(&table.mutex);
+    auto it = hash.constFind(key);
+    if (it != hash.constEnd())
+        return *it;
+    hash.insert(key, value);
+    return value;
+}
+
+/* Going through QImage keeps QPixmapCache, which is GUI thread only,
+ * out of the way */
+static QImage decode(const QString &urlPath)
+{
+    PaintTimer timer(PaintStats::Decode);
+
+    QImage image;
+    if (AssetStore::isAsset(urlPath))
+        image.loadFromData(qUncompress(AssetStore::compressedData(urlPath)));
+    else
+        image.load(urlPath);
+    return image;
+}
+
+/* Power of two side for a sprite of about size pixels, 0 when the full
+ * image is not larger than that */
+static int spriteBucket(const QSize &full, int size)
+{
+    const int fullSize = qMax(full.width(), full.height());
+
+    int bucket = MinSpriteSize;
+    while (bucket < size && bucket < fullSize)
+        bucket *= 2;
+    return bucket >= fullSize ? 0 : bucket;
+}
+
+static QImage scaledSprite(const QImage &full, int bucket)
+{
+    PaintTimer timer(PaintStats::Decode);
+    return full.scaled(bucket, bucket, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+/* Pixel data for deriving brushes and colors, from whichever table the
+ * calling thread uses */
+static QImage sourceImage(const QString &urlPath)
+{
+    return ImageCache::isGuiThread() ? ImageCache::pixmap(urlPath).toImage()
+                                     : ImageCache::image(urlPath);
+}
+
+bool ImageCache::isGuiThread()
+{
+    const QCoreApplication *app = QCoreApplication::instance();
+    return app && QThread::currentThread() == app->thread();
+}
+
+QPixmap ImageCache::pixmap(const QString &urlPath)
+{
+    Q_ASSERT(isGuiThread());
+    return cached(imageTable().pixmaps, urlPath,
+                  [&urlPath]() { return QPixmap::fromImage(decode(urlPath)); });
+}
+
+QImage ImageCache::image(const QString &urlPath)
+{
+    return cached(imageTable().images, urlPath, [&urlPath]() { return decode(urlPath); });
+}
+
+QPixmap ImageCache::sprite(const QString &urlPath, int size)
+{
+    const QPixmap full = pixmap(urlPath);
+    const int bucket = spriteBucket(full.size(), size);
+    if (!bucket)
+        return full;
+
+    return cached(imageTable().sprites, SpriteKey(urlPath, bucket), [&full, bucket]() {
+        return QPixmap::fromImage(scaledSprite(full.toImage(), bucket));
+    });
+}
+
+QImage ImageCache::spriteImage(const QString &urlPath, int size)
+{
+    const QImage full = image(urlPath);
+    const int bucket = spriteBucket(full.size(), size);
+    if (!bucket)
+        return full;
+
+    return cached(imageTable().spriteImages, SpriteKey(urlPath, bucket),
+                  [&full, bucket]() { return scaledSprite(full, bucket); });
+}
+
+QColor ImageCache::averageColor(const QString &urlPath)
+{
+    return cached(imageTable().colors, urlPath, [&urlPath]() -> QColor {
+        const QImage full = sourceImage(urlPath);
+        /* Smooth scaling down to one pixel averages the whole image */
+        return full.isNull() ? QColor(175, 175, 175)
+                : QColor(full.scaled(1, 1, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).pixel(0, 0));
+    });
+}
+
+/* Image brushes, unlike pixmap brushes, can be painted from any thread */
+QBrush ImageCache::floorBrush(const QString &urlPath)
+{
+    return cached(imageTable().brushes, urlPath, [&urlPath]() -> QBrush {
+        PaintTimer timer(PaintStats::Decode);
+        return QBrush(sourceImage(urlPath).scaled(FloorTileSize, FloorTileSize));
+    });
+}
+
+static qint64 pixelBytes(const QImage &image)
+{
+    return image.sizeInBytes();
+}
+
+static qint64 pixelBytes(const QPixmap &pixmap)
+{
+    return qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+/* Values only the hash refers to */
+template <class Key, class Value>
+static void dropUnshared(QHash<Key, Value> &hash)
+{
+    for (auto it = hash.begin(); it != hash.end(); ) {
+        if (it->isDetached())
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ImageCache::trim()
+{
+    ImageTable &table = imageTable();
+    QMutexLocker locker(&table.mutex);
+
+    dropUnshared(table.pixmaps);
+    dropUnshared(table.sprites);
+    dropUnshared(table.images);
+    dropUnshared(table.spriteImages);
+}
+
+ImageCache::Usage ImageCache::usage()
+{
+    ImageTable &table = imageTable();
+    QMutexLocker locker(&table.mutex);
+
+    Usage usage;
+    usage.pixmaps = table.pixmaps.size() + table.images.size();
+    for (const QPixmap &pixmap : table.pixmaps)
+        usage.pixmapBytes += pixelBytes(pixmap);
+    for (const QImage &image : table.images)
+        usage.pixmapBytes += pixelBytes(image);
+    usage.sprites = table.sprites.size() + table.spriteImages.size();
+    for (const QPixmap &sprite : table.sprites)
+        usage.spriteBytes += pixelBytes(sprite);
+    for (const QImage &sprite : table.spriteImages)
+        usage.spriteBytes += pixelBytes(sprite);
+    usage.brushes = table.brushes.size();
+    for (const QBrush &brush : table.brushes)
+        usage.brushBytes += pixelBytes(brush.textureImage());
+    return usage;
+}
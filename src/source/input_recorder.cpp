@@ -0,0 +1,250 @@
+#include <QAction>
+#include <QApplication>
+#include <QDialog>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QScreen>
+#include <QWheelEvent>
+
+#include "../headers/input_recorder.hpp"
+#include "../headers/design_window.hpp"
+#include "../headers/template_window.hpp"
+
+InputRecorder::InputRecorder(const QString &fileName, QObject *parent)
+    : QObject(parent), m_fileName(fileName), m_lastEvent(nullptr)
+{
+    qApp->installEventFilter(this);
+}
+
+InputRecorder::~InputRecorder()
+{
+    qApp->removeEventFilter(this);
+    if (!m_firstWindow.isEmpty() && !save())
+        qWarning("Could not write the input recording to %s", qPrintable(m_fileName));
+}
+
+bool InputRecorder::save() const
+{
+    const QScreen *primary = QGuiApplication::primaryScreen();
+    const QRect screen = primary ? primary->geometry() : QRect();
+
+    QJsonObject root;
+    root["version"] = FormatVersion;
+    root["window"] = m_firstWindow;
+    /* Windows center on the screen and furniture starts in its middle,
+     * a replay on another screen size may miss some items */
+    root["screenWidth"] = screen.width();
+    root["screenHeight"] = screen.height();
+    root["events"] = m_events;
+
+    QFile file(m_fileName);
+    return file.open(QIODevice::WriteOnly)
+            && file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) != -1;
+}
+
+static bool isPlannerWindow(const QObject *object)
+{
+    return qobject_cast<const TemplateWindow*>(object) || qobject_cast<const DesignWindow*>(object);
+}
+
+void InputRecorder::start(QWidget *window)
+{
+    m_firstWindow = window->metaObject()->className();
+    m_clock.start();
+}
+
+/* Menus are not recorded, the actions they trigger are */
+void InputRecorder::watchActions(QWidget *window)
+{
+    for (QAction *action : window->findChildren<QAction*>()) {
+        if (action->objectName().isEmpty() || action->property("recorded").toBool())
+            continue;
+        action->setProperty("recorded", true);
+        connect(action, &QAction::triggered, this, &InputRecorder::actionTriggered);
+    }
+}
+
+/* Planner windows and dialogs, but no menus or tooltips */
+bool InputRecorder::isRecorded(const QWidget *widget) const
+{
+    const QWidget *window = widget->window();
+    return isPlannerWindow(window) || qobject_cast<const QDialog*>(window);
+}
+
+void InputRecorder::append(QJsonObject event, const QWidget *target)
+{
+    event["t"] = m_clock.elapsed();
+    if (target)
+        event["target"] = pathOf(target);
+    m_events.append(event);
+}
+
+static QJsonObject mouseEvent(const char *type, const QMouseEvent *mouse)
+{
+    QJsonObject event;
+    event["type"] = type;
+    event["x"] = mouse->localPos().x();
+    event["y"] = mouse->localPos().y();
+    event["button"] = int(mouse->button());
+    event["buttons"] = int(mouse->buttons());
+    event["modifiers"] = int(mouse->modifiers());
+    return event;
+}
+
+bool InputRecorder::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show && isPlannerWindow(watched)) {
+        if (m_firstWindow.isEmpty())
+            start(static_cast<QWidget*>(watched));
+        watchActions(static_cast<QWidget*>(watched));
+        return false;
+    }
+
+    if (m_firstWindow.isEmpty() || !watched->isWidgetType() || !event->spontaneous()
+            || event == m_lastEvent)
+        return false;
+
+    QWidget *widget = static_cast<QWidget*>(watched);
+    if (!isRecorded(widget))
+        return false;
+
+    switch (event->type()) {
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease: {
+            const QKeyEvent *key = static_cast<QKeyEvent*>(event);
+            QJsonObject json;
+            json["type"] = event->type() == QEvent::KeyPress ? "keyPress" : "keyRelease";
+            json["key"] = key->key();
+            json["modifiers"] = int(key->modifiers());
+            json["text"] = key->text();
+            json["autoRepeat"] = key->isAutoRepeat();
+            append(json, widget);
+            break;
+        }
+
+        case QEvent::MouseButtonPress:
+            append(mouseEvent("mousePress", static_cast<QMouseEvent*>(event)), widget);
+            break;
+        case QEvent::MouseButtonRelease:
+            append(mouseEvent("mouseRelease", static_cast<QMouseEvent*>(event)), widget);
+            break;
+        case QEvent::MouseButtonDblClick:
+            append(mouseEvent("mouseDoubleClick", static_cast<QMouseEvent*>(event)), widget);
+            break;
+
+        /* Drags only, hovering changes nothing worth replaying */
+        case QEvent::MouseMove: {
+            const QMouseEvent *mouse = static_cast<QMouseEvent*>(event);
+            if (mouse->buttons() == Qt::NoButton)
+                return false;
+            append(mouseEvent("mouseMove", mouse), widget);
+            break;
+        }
+
+        case QEvent::Wheel: {
+            const QWheelEvent *wheel = static_cast<QWheelEvent*>(event);
+            QJsonObject json;
+            json["type"] = "wheel";
+            json["x"] = wheel->posF().x();
+            json["y"] = wheel->posF().y();
+            json["deltaX"] = wheel->angleDelta().x();
+            json["deltaY"] = wheel->angleDelta().y();
+            json["buttons"] = int(wheel->buttons());
+            json["modifiers"] = int(wheel->modifiers());
+            append(json, widget);
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    m_lastEvent = event;
+    return false;
+}
+
+void InputRecorder::actionTriggered()
+{
+    QAction *action = qobject_cast<QAction*>(sender());
+    QWidget *window = action ? qobject_cast<QWidget*>(action->parent()) : nullptr;
+    if (!window)
+        return;
+
+    QJsonObject json;
+    json["type"] = "action";
+    json["action"] = action->objectName();
+    json["checked"] = action->isChecked();
+    append(json, window->window());
+}
+
+QString InputRecorder::pathOf(const QWidget *widget)
+{
+    QStringList segments;
+    for (; widget; widget = widget->parentWidget()) {
+        const QString className = widget->metaObject()->className();
+
+        if (widget->isWindow()) {
+            segments.prepend(className);
+            break;
+        }
+        if (!widget->objectName().isEmpty()) {
+            segments.prepend(className + '#' + widget->objectName());
+            continue;
+        }
+
+        int index = 0;
+        for (const QObject *sibling : widget->parentWidget()->children()) {
+            if (sibling == widget)
+                break;
+            if (sibling->isWidgetType() && className == sibling->metaObject()->className())
+                index++;
+        }
+        segments.prepend(QString("%1[%2]").arg(className).arg(index));
+    }
+    return segments.join('/');
+}
+
+/* Windows are found by class, the modal one first, then the newest */
+static QWidget *windowOfClass(const QString &className)
+{
+    QWidget *modal = QApplication::activeModalWidget();
+    if (modal && className == modal->metaObject()->className())
+        return modal;
+
+    const QWidgetList windows = QApplication::topLevelWidgets();
+    for (int i = windows.size() - 1; i >= 0; i--)
+        if (windows.at(i)->isVisible() && className == windows.at(i)->metaObject()->className())
+            return windows.at(i);
+    return nullptr;
+}
+
+static QWidget *childAt(QWidget *parent, const QString &segment)
+{
+    const int hash = segment.indexOf('#');
+    const int bracket = segment.indexOf('[');
+    const QString className = segment.left(hash >= 0 ? hash : bracket);
+    const QString name = hash >= 0 ? segment.mid(hash + 1) : QString();
+    const int index = bracket >= 0 && hash < 0 ? segment.mid(bracket + 1).chopped(1).toInt() : 0;
+
+    int seen = 0;
+    for (QObject *child : parent->children()) {
+        if (!child->isWidgetType() || className != child->metaObject()->className())
+            continue;
+        if (hash >= 0 ? child->objectName() == name : seen++ == index)
+            return static_cast<QWidget*>(child);
+    }
+    return nullptr;
+}
+
+QWidget *InputRecorder::widgetAt(const QString &path)
+{
+    const QStringList segments = path.split('/');
+    QWidget *widget = windowOfClass(segments.first());
+    for (int i = 1; widget && i < segments.size(); i++)
+        widget = childAt(widget, segments.at(i));
+    return widget;
+}
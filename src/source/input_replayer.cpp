@@ -0,0 +1,247 @@
+#include <QAction>
+#include <QApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QTimer>
+#include <QWheelEvent>
+
+#include <algorithm>
+
+#include "../headers/input_replayer.hpp"
+#include "../headers/input_recorder.hpp"
+#include "../headers/paint_stats.hpp"
+#include "../headers/plan_view.hpp"
+
+/* Frames slower than this missed a 60 Hz refresh */
+static const qint64 FrameBudget = 16667 * 1000;     // Nanoseconds
+
+InputReplayer::InputReplayer(QObject *parent)
+    : QObject(parent), m_pace(Fast), m_next(0), m_wallTime(0), m_missedTargets(0)
+{
+}
+
+bool InputReplayer::load(const QString &fileName, QString *errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll(), &parseError).object();
+    if (parseError.error != QJsonParseError::NoError) {
+        if (errorString)
+            *errorString = parseError.errorString();
+        return false;
+    }
+    if (root["version"].toInt() != InputRecorder::FormatVersion || root["window"].toString().isEmpty()) {
+        if (errorString)
+            *errorString = "Not an input recording";
+        return false;
+    }
+
+    m_window = root["window"].toString();
+    m_events = root["events"].toArray();
+    return true;
+}
+
+QString InputReplayer::window() const
+{
+    return m_window;
+}
+
+int InputReplayer::eventCount() const
+{
+    return m_events.size();
+}
+
+void InputReplayer::start(Pace pace)
+{
+    m_pace = pace;
+    m_next = 0;
+    m_frameTimes.clear();
+    m_eventTimes.clear();
+    m_eventTimes.reserve(m_events.size());
+    m_missedTargets = 0;
+
+    m_clock.start();
+    QTimer::singleShot(0, this, &InputReplayer::replayNext);
+}
+
+/* Views of windows opened during the replay count as well */
+void InputReplayer::watchViews()
+{
+    for (QWidget *window : QApplication::topLevelWidgets()) {
+        for (PlanView *view : window->findChildren<PlanView*>()) {
+            if (view->property("replayed").toBool())
+                continue;
+            view->setProperty("replayed", true);
+            connect(view, &PlanView::framePainted, this, &InputReplayer::framePainted);
+        }
+    }
+}
+
+void InputReplayer::replayNext()
+{
+    if (m_next >= m_events.size()) {
+        m_wallTime = m_clock.elapsed();
+        QTimer::singleShot(SettleDelay, this, &InputReplayer::finish);
+        return;
+    }
+
+    watchViews();
+    const QJsonObject event = m_events.at(m_next++).toObject();
+
+    /* Scheduled before the event is sent: one that opens a dialog returns
+     * only when the dialog closes, the replay goes on inside it */
+    qint64 delay = 0;
+    if (m_pace == Realtime && m_next < m_events.size())
+        delay = qMax<qint64>(0, qint64(m_events.at(m_next).toObject()["t"].toDouble()) - m_clock.elapsed());
+    QTimer::singleShot(int(delay), this, &InputReplayer::replayNext);
+
+    const qint64 start = PaintStats::now();
+    if (!replay(event)) {
+        m_missedTargets++;
+        return;
+    }
+    m_eventTimes.append(PaintStats::now() - start);
+
+    /* Fast replay paints every event's frame before the next event */
+    if (m_pace == Fast)
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::UpdateRequest);
+}
+
+void InputReplayer::framePainted(qint64 nsecs)
+{
+    m_frameTimes.append(nsecs);
+}
+
+void InputReplayer::finish()
+{
+    emit finished();
+}
+
+static Qt::KeyboardModifiers modifiersOf(const QJsonObject &event)
+{
+    return Qt::KeyboardModifiers(event["modifiers"].toInt());
+}
+
+bool InputReplayer::replay(const QJsonObject &event)
+{
+    QWidget *target = InputRecorder::widgetAt(event["target"].toString());
+    if (!target)
+        return false;
+
+    const QString type = event["type"].toString();
+    const QPointF pos(event["x"].toDouble(), event["y"].toDouble());
+
+    if (type == "action") {
+        QAction *action = target->findChild<QAction*>(event["action"].toString());
+        if (!action || !action->isEnabled())
+            return false;
+        /* Checkable actions were recorded in the state they ended in */
+        if (!action->isCheckable() || action->isChecked() != event["checked"].toBool())
+            action->trigger();
+        return true;
+    }
+
+    if (type == "keyPress" || type == "keyRelease") {
+        QKeyEvent key(type == "keyPress" ? QEvent::KeyPress : QEvent::KeyRelease,
+                      event["key"].toInt(), modifiersOf(event),
+                      event["text"].toString(), event["autoRepeat"].toBool());
+        QApplication::sendEvent(target, &key);
+        return true;
+    }
+
+    if (type == "wheel") {
+        const QPoint delta(event["deltaX"].toInt(), event["deltaY"].toInt());
+        const bool vertical = delta.y() != 0;
+        QWheelEvent wheel(pos, target->mapToGlobal(pos.toPoint()), QPoint(), delta,
+                          vertical ? delta.y() : delta.x(), vertical ? Qt::Vertical : Qt::Horizontal,
+                          Qt::MouseButtons(event["buttons"].toInt()), modifiersOf(event));
+        QApplication::sendEvent(target, &wheel);
+        return true;
+    }
+
+    QEvent::Type mouseType;
+    if (type == "mousePress")
+        mouseType = QEvent::MouseButtonPress;
+    else if (type == "mouseRelease")
+        mouseType = QEvent::MouseButtonRelease;
+    else if (type == "mouseDoubleClick")
+        mouseType = QEvent::MouseButtonDblClick;
+    else if (type == "mouseMove")
+        mouseType = QEvent::MouseMove;
+    else
+        return false;
+
+    QMouseEvent mouse(mouseType, pos, target->mapToGlobal(pos.toPoint()),
+                      Qt::MouseButton(event["button"].toInt()),
+                      Qt::MouseButtons(event["buttons"].toInt()), modifiersOf(event));
+    QApplication::sendEvent(target, &mouse);
+    return true;
+}
+
+/* Median, 95th percentile and maximum, in milliseconds */
+static QJsonObject distribution(QVector<qint64> nsecs)
+{
+    QJsonObject stats;
+    stats["count"] = nsecs.size();
+    if (nsecs.isEmpty())
+        return stats;
+
+    std::sort(nsecs.begin(), nsecs.end());
+    stats["median"] = nsecs.at(nsecs.size() / 2) / 1e6;
+    stats["p95"] = nsecs.at(qMin(nsecs.size() - 1, nsecs.size() * 95 / 100)) / 1e6;
+    stats["max"] = nsecs.last() / 1e6;
+    return stats;
+}
+
+QString InputReplayer::summary() const
+{
+    const QJsonObject frames = distribution(m_frameTimes);
+    const QJsonObject events = distribution(m_eventTimes);
+    const int slowFrames = int(std::count_if(m_frameTimes.begin(), m_frameTimes.end(),
+                                             [](qint64 nsecs) { return nsecs > FrameBudget; }));
+
+    return QString("Replay (%1): %2 events in %3 ms, %4 without a target\n"
+                   "Frames: %5, median %6 ms, 95th percentile %7 ms, max %8 ms, %9 over 16 ms\n"
+                   "Event handling: median %10 ms, 95th percentile %11 ms, max %12 ms")
+            .arg(m_pace == Fast ? "fast" : "realtime")
+            .arg(m_events.size())
+            .arg(m_wallTime)
+            .arg(m_missedTargets)
+            .arg(m_frameTimes.size())
+            .arg(frames["median"].toDouble(), 0, 'f', 2)
+            .arg(frames["p95"].toDouble(), 0, 'f', 2)
+            .arg(frames["max"].toDouble(), 0, 'f', 2)
+            .arg(slowFrames)
+            .arg(events["median"].toDouble(), 0, 'f', 2)
+            .arg(events["p95"].toDouble(), 0, 'f', 2)
+            .arg(events["max"].toDouble(), 0, 'f', 2);
+}
+
+bool InputReplayer::saveReport(const QString &fileName) const
+{
+    QJsonArray frameTimes;
+    for (qint64 nsecs : m_frameTimes)
+        frameTimes.append(nsecs / 1e6);
+
+    QJsonObject root;
+    root["pace"] = m_pace == Fast ? "fast" : "realtime";
+    root["events"] = m_events.size();
+    root["missedTargets"] = m_missedTargets;
+    root["wallTime"] = double(m_wallTime);
+    root["frames"] = distribution(m_frameTimes);
+    root["eventHandling"] = distribution(m_eventTimes);
+    root["frameTimes"] = frameTimes;
+
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly)
+            && file.write(QJsonDocument(root).toJson()) != -1;
+}
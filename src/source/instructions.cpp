@@ -8,7 +8,11 @@ Instructions::Instructions(QWidget *parent) :
     ui->setupUi(this);
     setWindowCenter(1.75, 1.5);
     setWindowTitle("Instructions");
+    reset();
+}
 
+void Instructions::reset()
+{
     /* Start with the first tab opened */
     ui->tabWidget->setCurrentIndex(0);
 }
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <QMutexLocker>
+
+#include "../headers/item_pool.hpp"
+
+/* Blocks have to hold the free list link and keep the alignment that
+ * operator new would have given */
+static std::size_t blockSizeFor(std::size_t size)
+{
+    const std::size_t alignment = alignof(std::max_align_t);
+    size = qMax(size, sizeof(void*));
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+ItemPool::ItemPool(std::size_t blockSize)
+    : m_blockSize(blockSizeFor(blockSize)), m_free(nullptr), m_used(0)
+{
+}
+
+ItemPool::~ItemPool()
+{
+    for (char *chunk : m_chunks)
+        ::operator delete(chunk);
+}
+
+void ItemPool::addChunk()
+{
+    char *chunk = static_cast<char*>(::operator new(m_blockSize * BlocksPerChunk));
+    m_chunks.append(chunk);
+
+    /* Threaded back to front, so blocks are handed out in address order */
+    for (int i = BlocksPerChunk - 1; i >= 0; i--) {
+        FreeBlock *block = reinterpret_cast<FreeBlock*>(chunk + i * m_blockSize);
+        block->next = m_free;
+        m_free = block;
+    }
+}
+
+void *ItemPool::allocate(std::size_t size)
+{
+    if (blockSizeFor(size) != m_blockSize)
+        return ::operator new(size);
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_free)
+        addChunk();
+
+    FreeBlock *block = m_free;
+    m_free = block->next;
+    m_used++;
+    return block;
+}
+
+void ItemPool::deallocate(void *block, std::size_t size)
+{
+    if (!block)
+        return;
+    if (blockSizeFor(size) != m_blockSize) {
+        ::operator delete(block);
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    FreeBlock *freed = static_cast<FreeBlock*>(block);
+    freed->next = m_free;
+    m_free = freed;
+    m_used--;
+}
+
+/* Index of the chunk holding block, chunks sorted by address */
+static int chunkOf(const QVector<char*> &chunks, const void *block)
+{
+    const char *address = static_cast<const char*>(block);
+    return int(std::upper_bound(chunks.begin(), chunks.end(), address, std::less<const char*>())
+               - chunks.begin()) - 1;
+}
+
+void ItemPool::trim()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QVector<char*> chunks = m_chunks;
+    std::sort(chunks.begin(), chunks.end(), std::less<char*>());
+
+    /* A chunk is empty when all of its blocks are on the free list */
+    QVector<int> freeBlocks(chunks.size(), 0);
+    for (FreeBlock *block = m_free; block; block = block->next)
+        freeBlocks[chunkOf(chunks, block)]++;
+    /* A copy, contains() takes a reference and BlocksPerChunk has no definition */
+    const int allFree = BlocksPerChunk;
+    if (!freeBlocks.contains(allFree))
+        return;
+
+    /* Rethreaded in the same order, without the blocks of empty chunks */
+    FreeBlock *kept = nullptr;
+    FreeBlock **tail = &kept;
+    for (FreeBlock *block = m_free; block; block = block->next) {
+        if (freeBlocks.at(chunkOf(chunks, block)) == allFree)
+            continue;
+        *tail = block;
+        tail = &block->next;
+    }
+    *tail = nullptr;
+    m_free = kept;
+
+    m_chunks.clear();
+    for (int i = 0; i < chunks.size(); i++) {
+        if (freeBlocks.at(i) == allFree)
+            ::operator delete(chunks.at(i));
+        else
+            m_chunks.append(chunks.at(i));
+    }
+}
+
+ItemPool::Usage ItemPool::usage() const
+{
+    QMutexLocker locker(&m_mutex);
+    Usage usage;
+    usage.used = m_used;
+    usage.capacity = m_chunks.size() * BlocksPerChunk;
+    usage.bytes = qint64(m_chunks.size()) * BlocksPerChunk * qint64(m_blockSize);
+    return usage;
+}
@@ -0,0 +1,483 @@
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <cstring>
+
+#include "../headers/json_interchange.hpp"
+#include "../headers/trace.hpp"
+
+static void setError(QString *errorString, const QString &message)
+{
+    if (errorString)
+        *errorString = message;
+}
+
+/* Records */
+
+QJsonObject JsonInterchange::toJson(const PlanRecord &record)
+{
+    QJsonObject object;
+    object["id"]     = double(record.id);
+    object["kind"]   = record.kind == PlanRecord::RoomKind ? "room" : "furniture";
+    object["image"]  = record.urlPath;
+    object["x"]      = record.x;
+    object["y"]      = record.y;
+    object["width"]  = record.width;
+    object["height"] = record.height;
+    object["angle"]  = record.angle;
+    object["z"]      = record.zValue;
+
+    if (record.kind == PlanRecord::FurnitureKind)
+        object["flipped"] = record.flipped;
+
+    return object;
+}
+
+PlanRecord JsonInterchange::fromJson(const QJsonObject &object)
+{
+    PlanRecord record;
+    record.id      = quint64(object.value("id").toDouble());
+    record.kind    = object.value("kind").toString() == "room" ? PlanRecord::RoomKind
+                                                               : PlanRecord::FurnitureKind;
+    record.urlPath = object.value("image").toString();
+    record.x       = object.value("x").toDouble();
+    record.y       = object.value("y").toDouble();
+    record.width   = object.value("width").toDouble();
+    record.height  = object.value("height").toDouble();
+    record.angle   = object.value("angle").toDouble();
+    record.zValue  = object.value("z").toDouble();
+    record.flipped = object.value("flipped").toBool();
+    return record;
+}
+
+bool JsonInterchange::readDocument(const QByteArray &json, QVector<PlanRecord> &records,
+                                   QString *errorString)
+{
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (!document.isObject()) {
+        setError(errorString, parseError.errorString());
+        return false;
+    }
+
+    const QJsonObject root = document.object();
+    if (root.value("format").toString() != FormatName) {
+        setError(errorString, "Not a Home Planner 2D plan");
+        return false;
+    }
+    if (root.value("version").toInt() > Version) {
+        setError(errorString, "Unsupported plan version");
+        return false;
+    }
+
+    const QJsonArray items = root.value("items").toArray();
+    records.reserve(records.size() + items.size());
+    for (const QJsonValue &item : items)
+        records.append(fromJson(item.toObject()));
+
+    return true;
+}
+
+bool JsonInterchange::save(const QString &fileName, const QVector<PlanRecord> &records,
+                           QString *errorString)
+{
+    TraceSpan span("JsonInterchange::save", "io");
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    JsonPlanWriter writer(&file);
+    writer.writeStart();
+    for (const PlanRecord &record : records)
+        writer.writeRecord(record);
+    writer.writeEnd();
+
+    if (file.error() != QFileDevice::NoError) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool JsonInterchange::load(const QString &fileName, QVector<PlanRecord> &records,
+                           QString *errorString)
+{
+    TraceSpan span("JsonInterchange::load", "io");
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    if (file.size() <= DocumentLimit)
+        return readDocument(file.readAll(), records, errorString);
+
+    JsonPlanReader reader(&file);
+    PlanRecord record;
+    while (reader.readNext(record))
+        records.append(record);
+
+    if (reader.hasError()) {
+        setError(errorString, reader.errorString());
+        return false;
+    }
+    return true;
+}
+
+/* Writer */
+
+JsonPlanWriter::JsonPlanWriter(QIODevice *device)
+    : m_device(device), m_first(true)
+{
+}
+
+void JsonPlanWriter::writeStart()
+{
+    m_device->write("{\"format\":\"" + JsonInterchange::FormatName.toUtf8()
+                    + "\",\"version\":" + QByteArray::number(JsonInterchange::Version)
+                    + ",\"items\":[\n");
+    m_first = true;
+}
+
+void JsonPlanWriter::writeRecord(const PlanRecord &record)
+{
+    if (!m_first)
+        m_device->write(",\n");
+    m_first = false;
+
+    m_device->write(QJsonDocument(JsonInterchange::toJson(record)).toJson(QJsonDocument::Compact));
+}
+
+void JsonPlanWriter::writeEnd()
+{
+    m_device->write("\n]}\n");
+}
+
+/* Tokenizer */
+
+JsonTokenizer::JsonTokenizer(QIODevice *device)
+    : m_device(device), m_pos(0), m_number(0)
+{
+}
+
+bool JsonTokenizer::fill()
+{
+    if (m_pos < m_block.size())
+        return true;
+
+    m_block = m_device->read(BlockSize);
+    m_pos = 0;
+    return !m_block.isEmpty();
+}
+
+int JsonTokenizer::peek()
+{
+    if (!fill())
+        return -1;
+    return uchar(m_block.at(m_pos));
+}
+
+int JsonTokenizer::get()
+{
+    const int c = peek();
+    if (c >= 0)
+        m_pos++;
+    return c;
+}
+
+JsonTokenizer::Token JsonTokenizer::next()
+{
+    for (;;) {
+        const int c = get();
+        switch (c) {
+            case -1:
+                return EndOfInput;
+
+            /* Whitespace and separators */
+            case ' ': case '\t': case '\n': case '\r': case ',': case ':':
+                continue;
+
+            case '{': return BeginObject;
+            case '}': return EndObject;
+            case '[': return BeginArray;
+            case ']': return EndArray;
+
+            case '"': return readString() ? String : Invalid;
+            case 't': return readLiteral("rue") ? True : Invalid;
+            case 'f': return readLiteral("alse") ? False : Invalid;
+            case 'n': return readLiteral("ull") ? Null : Invalid;
+
+            default:
+                if (c == '-' || (c >= '0' && c <= '9'))
+                    return readNumber(char(c)) ? Number : Invalid;
+
+                m_error = "Unexpected character in JSON";
+                return Invalid;
+        }
+    }
+}
+
+bool JsonTokenizer::readString()
+{
+    QByteArray utf8;
+
+    auto readHex4 = [this]() -> int {
+        int value = 0;
+        for (int i = 0; i < 4; i++) {
+            const int c = get();
+            const int digit = c >= '0' && c <= '9' ? c - '0'
+                            : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                            : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0)
+                return -1;
+            value = value * 16 + digit;
+        }
+        return value;
+    };
+
+    for (;;) {
+        int c = get();
+        if (c < 0) {
+            m_error = "Unterminated string in JSON";
+            return false;
+        }
+        if (c == '"')
+            break;
+        if (c != '\\') {
+            utf8.append(char(c));
+            continue;
+        }
+
+        c = get();
+        switch (c) {
+            case '"': case '\\': case '/':
+                utf8.append(char(c));
+                break;
+            case 'b': utf8.append('\b'); break;
+            case 'f': utf8.append('\f'); break;
+            case 'n': utf8.append('\n'); break;
+            case 'r': utf8.append('\r'); break;
+            case 't': utf8.append('\t'); break;
+
+            case 'u': {
+                QChar units[2];
+                int count = 1;
+                int unit = readHex4();
+                if (unit < 0) {
+                    m_error = "Bad \\u escape in JSON";
+                    return false;
+                }
+                units[0] = QChar(ushort(unit));
+
+                /* Characters outside the BMP come as surrogate pairs */
+                if (units[0].isHighSurrogate() && get() == '\\' && get() == 'u') {
+                    unit = readHex4();
+                    if (unit < 0) {
+                        m_error = "Bad \\u escape in JSON";
+                        return false;
+                    }
+                    units[1] = QChar(ushort(unit));
+                    count = 2;
+                }
+                utf8 += QString(units, count).toUtf8();
+                break;
+            }
+
+            default:
+                m_error = "Bad escape sequence in JSON";
+                return false;
+        }
+    }
+
+    m_text = QString::fromUtf8(utf8);
+    return true;
+}
+
+bool JsonTokenizer::readNumber(char first)
+{
+    QByteArray digits(1, first);
+    for (int c = peek(); c > 0 && std::strchr("0123456789+-.eE", c); c = peek())
+        digits.append(char(get()));
+
+    bool ok;
+    m_number = digits.toDouble(&ok);
+    if (!ok)
+        m_error = "Bad number in JSON";
+    return ok;
+}
+
+bool JsonTokenizer::readLiteral(const char *rest)
+{
+    for (; *rest; rest++) {
+        if (get() != *rest) {
+            m_error = "Unexpected literal in JSON";
+            return false;
+        }
+    }
+    return true;
+}
+
+QString JsonTokenizer::text() const
+{
+    return m_text;
+}
+
+double JsonTokenizer::number() const
+{
+    return m_number;
+}
+
+QString JsonTokenizer::errorString() const
+{
+    return m_error;
+}
+
+/* Streaming reader */
+
+JsonPlanReader::JsonPlanReader(QIODevice *device)
+    : m_tokens(device), m_state(Start)
+{
+}
+
+bool JsonPlanReader::fail(const QString &message)
+{
+    if (m_error.isEmpty())
+        m_error = m_tokens.errorString().isEmpty() ? message : m_tokens.errorString();
+    m_state = Done;
+    return false;
+}
+
+bool JsonPlanReader::skipValue(JsonTokenizer::Token token)
+{
+    if (token == JsonTokenizer::Invalid || token == JsonTokenizer::EndOfInput)
+        return fail("Unexpected end of JSON");
+    if (token != JsonTokenizer::BeginObject && token != JsonTokenizer::BeginArray)
+        return true;
+
+    int depth = 1;
+    while (depth > 0) {
+        token = m_tokens.next();
+        if (token == JsonTokenizer::BeginObject || token == JsonTokenizer::BeginArray)
+            depth++;
+        else if (token == JsonTokenizer::EndObject || token == JsonTokenizer::EndArray)
+            depth--;
+        else if (token == JsonTokenizer::Invalid || token == JsonTokenizer::EndOfInput)
+            return fail("Unexpected end of JSON");
+    }
+    return true;
+}
+
+/* Walks the root object up to the "items" array. Items are read as they
+ * come, so "format" has to be checked before them: readDocument() would
+ * reject the same file without it. */
+bool JsonPlanReader::findItems()
+{
+    if (m_tokens.next() != JsonTokenizer::BeginObject)
+        return fail("Expected a JSON object");
+
+    bool format = false;
+    for (;;) {
+        JsonTokenizer::Token token = m_tokens.next();
+        if (token == JsonTokenizer::EndObject) {
+            if (!format)
+                return fail("Not a Home Planner 2D plan");
+            m_state = Done;     // A plan without items
+            return false;
+        }
+        if (token != JsonTokenizer::String)
+            return fail("Expected a key");
+
+        const QString key = m_tokens.text();
+        token = m_tokens.next();
+
+        if (key == "items") {
+            if (!format)
+                return fail("Not a Home Planner 2D plan, \"format\" has to come before \"items\"");
+            if (token != JsonTokenizer::BeginArray)
+                return fail("\"items\" must be an array");
+            m_state = InItems;
+            return true;
+        }
+        if (key == "format") {
+            if (token != JsonTokenizer::String || m_tokens.text() != JsonInterchange::FormatName)
+                return fail("Not a Home Planner 2D plan");
+            format = true;
+        }
+        if (key == "version" && (token != JsonTokenizer::Number
+                                 || m_tokens.number() > JsonInterchange::Version))
+            return fail("Unsupported plan version");
+
+        if (!skipValue(token))
+            return false;
+    }
+}
+
+bool JsonPlanReader::readRecord(PlanRecord &record)
+{
+    record = PlanRecord();
+
+    for (;;) {
+        JsonTokenizer::Token token = m_tokens.next();
+        if (token == JsonTokenizer::EndObject)
+            return true;
+        if (token != JsonTokenizer::String)
+            return fail("Expected a key");
+
+        const QString key = m_tokens.text();
+        token = m_tokens.next();
+
+        if (token == JsonTokenizer::Number) {
+            const double value = m_tokens.number();
+            if (key == "id")            record.id = quint64(value);
+            else if (key == "x")        record.x = value;
+            else if (key == "y")        record.y = value;
+            else if (key == "width")    record.width = value;
+            else if (key == "height")   record.height = value;
+            else if (key == "angle")    record.angle = value;
+            else if (key == "z")        record.zValue = value;
+        }
+        else if (token == JsonTokenizer::String) {
+            if (key == "kind")
+                record.kind = m_tokens.text() == "room" ? PlanRecord::RoomKind
+                                                        : PlanRecord::FurnitureKind;
+            else if (key == "image")
+                record.urlPath = m_tokens.text();
+        }
+        else if (token == JsonTokenizer::True || token == JsonTokenizer::False) {
+            if (key == "flipped")
+                record.flipped = token == JsonTokenizer::True;
+        }
+        else if (!skipValue(token)) {
+            return false;
+        }
+    }
+}
+
+bool JsonPlanReader::readNext(PlanRecord &record)
+{
+    if (m_state == Start && !findItems())
+        return false;
+    if (m_state != InItems)
+        return false;
+
+    const JsonTokenizer::Token token = m_tokens.next();
+    if (token == JsonTokenizer::BeginObject)
+        return readRecord(record);
+    if (token == JsonTokenizer::EndArray) {
+        m_state = Done;     // Nothing after the items is needed
+        return false;
+    }
+    return fail("Expected an item");
+}
+
+bool JsonPlanReader::hasError() const
+{
+    return !m_error.isEmpty();
+}
+
+QString JsonPlanReader::errorString() const
+{
+    return m_error;
+}
@@ -1,12 +1,76 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QScopedPointer>
 
-#include "../headers/main_menu_window.hpp"
+#include <cstdio>
+
+#include "../headers/window_manager.hpp"
+#include "../headers/input_recorder.hpp"
+#include "../headers/input_replayer.hpp"
+#include "../headers/startup_timer.hpp"
+
+/* Opens the window a recording started in and plays it back, see InputReplayer */
+static int replay(QApplication &app, const QString &fileName, InputReplayer::Pace pace,
+                  const QString &reportFile)
+{
+    InputReplayer replayer;
+    QString errorString;
+    if (!replayer.load(fileName, &errorString)) {
+        std::fprintf(stderr, "Could not load %s: %s\n", qPrintable(fileName), qPrintable(errorString));
+        return 1;
+    }
+
+    /* Sessions that close their window still end with the report */
+    app.setQuitOnLastWindowClosed(false);
+
+    if (replayer.window() == "TemplateWindow")
+        WindowManager::instance()->showTemplate();
+    else if (replayer.window() == "DesignWindow")
+        WindowManager::instance()->showDesign();
+    else {
+        std::fprintf(stderr, "Unknown window in %s: %s\n", qPrintable(fileName), qPrintable(replayer.window()));
+        return 1;
+    }
+
+    QObject::connect(&replayer, &InputReplayer::finished, &app, &QApplication::quit);
+    replayer.start(pace);
+    app.exec();
+
+    std::printf("%s\n", qPrintable(replayer.summary()));
+    if (!reportFile.isEmpty() && !replayer.saveReport(reportFile)) {
+        std::fprintf(stderr, "Could not write %s\n", qPrintable(reportFile));
+        return 1;
+    }
+    return 0;
+}
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    MainMenuWindow w;
-    w.show();
+    StartupTimer::mark("application created");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption replayOption("replay", "Play back an input recording and report frame times.", "file");
+    QCommandLineOption realtimeOption("realtime", "Keep the recorded pace instead of replaying as fast as possible.");
+    QCommandLineOption reportOption("report", "Save the replay report as JSON.", "file");
+    parser.addOption(replayOption);
+    parser.addOption(realtimeOption);
+    parser.addOption(reportOption);
+    parser.process(a);
+
+    if (parser.isSet(replayOption))
+        return replay(a, parser.value(replayOption),
+                      parser.isSet(realtimeOption) ? InputReplayer::Realtime : InputReplayer::Fast,
+                      parser.value(reportOption));
+
+    /* HOMEPLANNER_RECORD=session.json records the session for --replay */
+    QScopedPointer<InputRecorder> recorder;
+    const QString recordFile = qEnvironmentVariable("HOMEPLANNER_RECORD");
+    if (!recordFile.isEmpty())
+        recorder.reset(new InputRecorder(recordFile));
+
+    WindowManager::instance()->showMainMenu();
 
     return a.exec();
 }
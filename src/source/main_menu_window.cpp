@@ -5,6 +5,7 @@
 
 #include "ui_main_menu_window.h"
 #include "../headers/main_menu_window.hpp"
+#include "../headers/window_manager.hpp"
 
 MainMenuWindow::MainMenuWindow(QWidget *parent)
     : CenteredWindow(parent), ui(new Ui::MainMenuWindow)
@@ -12,14 +13,18 @@ MainMenuWindow::MainMenuWindow(QWidget *parent)
     ui->setupUi(this);
 
     /* Only main menu window is non-resizable */
-    setWindowCenter(2.5, 1.5);
-    setFixedSize(size());
+    reset();
     setBackgroundImage();
 
+    setWindowTitle("Home Planner 2D");
+}
+
+void MainMenuWindow::reset()
+{
     /* First page is default on start */
     ui->stackedWidget->setCurrentIndex(0);
-
-    setWindowTitle("Home Planner 2D");
+    setWindowCenter(2.5, 1.5);
+    setFixedSize(size());
 }
 
 MainMenuWindow::~MainMenuWindow()
@@ -53,9 +58,7 @@ void MainMenuWindow::on_btnCreateNew_clicked()
 void MainMenuWindow::on_btnBack_clicked()
 {
     /* Go to first page */
-    ui->stackedWidget->setCurrentIndex(0);
-    setWindowCenter(2.5, 1.5);
-    setFixedSize(size());
+    reset();
 }
 
 void MainMenuWindow::on_btnAbout_clicked()
@@ -67,24 +70,22 @@ void MainMenuWindow::on_btnAbout_clicked()
        "Mathematics, University of Belgrade in Serbia.");
 }
 
+/* Windows are built once and reused, see WindowManager */
 void MainMenuWindow::on_btnInstructions_clicked()
 {
-    instructions = new Instructions;
-    instructions->show();
+    WindowManager::instance()->showInstructions();
 }
 
 void MainMenuWindow::on_btnTemplate_clicked()
 {
-   tempWind = new TemplateWindow(this);
-   hide();
-   tempWind->show();
+    hide();
+    WindowManager::instance()->showTemplate();
 }
 
 void MainMenuWindow::on_btnScratch_clicked()
 {
-    designWind = new DesignWindow();
     hide();
-    designWind->show();
+    WindowManager::instance()->showDesign();
 }
 
 void MainMenuWindow::on_btnQt_clicked()
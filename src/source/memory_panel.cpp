@@ -0,0 +1,109 @@
+#include <QDateTime>
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPointer>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "../headers/memory_panel.hpp"
+
+enum Column { KindColumn, CountColumn, BytesColumn, ChangeColumn, ColumnCount };
+
+static QString kilobytes(qint64 bytes)
+{
+    return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+}
+
+static QString signedChange(qint64 change)
+{
+    return change > 0 ? QString("+%1").arg(change) : QString::number(change);
+}
+
+void MemoryPanel::showPanel()
+{
+    static QPointer<MemoryPanel> panel;
+    if (!panel)
+        panel = new MemoryPanel;
+
+    panel->show();
+    panel->raise();
+    panel->activateWindow();
+}
+
+MemoryPanel::MemoryPanel(QWidget *parent)
+    : QDialog(parent), m_table(new QTableWidget(MemoryStats::KindCount, ColumnCount, this)),
+      m_windows(new QLabel(this))
+{
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle("Memory Usage");
+
+    m_table->setHorizontalHeaderLabels({ "", "Count", "Size", "Since snapshot" });
+    m_table->verticalHeader()->hide();
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+    for (int row = 0; row < MemoryStats::KindCount; row++) {
+        m_table->setItem(row, KindColumn, new QTableWidgetItem(MemoryStats::kindName(MemoryStats::Kind(row))));
+        for (int column = CountColumn; column < ColumnCount; column++) {
+            QTableWidgetItem *item = new QTableWidgetItem;
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_table->setItem(row, column, item);
+        }
+    }
+
+    m_windows->setWordWrap(true);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton *snapshot = buttons->addButton("Take Snapshot", QDialogButtonBox::ActionRole);
+    connect(snapshot, &QPushButton::clicked, this, &MemoryPanel::takeSnapshot);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::close);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_table);
+    layout->addWidget(m_windows);
+    layout->addWidget(buttons);
+    resize(480, 360);
+
+    takeSnapshot();
+
+    connect(&m_timer, &QTimer::timeout, this, &MemoryPanel::refresh);
+    m_timer.start(RefreshInterval);
+}
+
+void MemoryPanel::takeSnapshot()
+{
+    m_snapshot = MemoryStats::take();
+    refresh();
+}
+
+void MemoryPanel::refresh()
+{
+    const MemoryStats::Snapshot now = MemoryStats::take();
+    const QVector<MemoryStats::Kind> grown = MemoryStats::growth(m_snapshot, now);
+
+    for (int row = 0; row < MemoryStats::KindCount; row++) {
+        const MemoryStats::Kind kind = MemoryStats::Kind(row);
+        const MemoryStats::Entry &entry = now[kind];
+        const MemoryStats::Entry &was = m_snapshot[kind];
+
+        m_table->item(row, CountColumn)->setText(QString::number(entry.count));
+        m_table->item(row, BytesColumn)->setText(kilobytes(entry.bytes));
+        m_table->item(row, ChangeColumn)->setText(QString("%1, %2 KB")
+                .arg(signedChange(entry.count - was.count))
+                .arg(signedChange((entry.bytes - was.bytes) / 1024)));
+
+        const QBrush foreground = grown.contains(kind) ? QBrush(Qt::red) : QBrush();
+        for (int column = 0; column < ColumnCount; column++)
+            m_table->item(row, column)->setForeground(foreground);
+    }
+
+    QStringList windows;
+    for (auto it = now.windowClasses.constBegin(); it != now.windowClasses.constEnd(); ++it)
+        windows.append(QString("%1 %2").arg(it.key()).arg(it.value()));
+    m_windows->setText(QString("Windows: %1, %2 hidden.\nSnapshot taken at %3.")
+            .arg(windows.join(", "))
+            .arg(now.hiddenWindows)
+            .arg(QDateTime::fromMSecsSinceEpoch(m_snapshot.time).toString("HH:mm:ss")));
+}
@@ -0,0 +1,126 @@
+#include <QApplication>
+#include <QDateTime>
+#include <QDialog>
+#include <QMainWindow>
+
+#include "../headers/memory_stats.hpp"
+#include "../headers/room.hpp"
+#include "../headers/furniture.hpp"
+#include "../headers/furniture_asset.hpp"
+#include "../headers/image_cache.hpp"
+
+/* Windows are the planner's own, menus and tooltips come and go */
+static bool isCounted(const QWidget *widget)
+{
+    return qobject_cast<const QMainWindow*>(widget) || qobject_cast<const QDialog*>(widget);
+}
+
+MemoryStats::Snapshot MemoryStats::take()
+{
+    Snapshot snapshot;
+    snapshot.time = QDateTime::currentMSecsSinceEpoch();
+
+    /* Items are a view and an entry in their scene's model */
+    snapshot.entries[Rooms].count = Room::numberRooms;
+    snapshot.entries[Rooms].bytes = qint64(Room::numberRooms) * (sizeof(Room) + sizeof(PlanItem));
+    /* Kind::Furniture hides the class here. Furniture takes whole pool
+     * chunks, freed blocks included. */
+    snapshot.entries[Furniture].count = ::Furniture::numberFurniture;
+    snapshot.entries[Furniture].bytes = ::Furniture::poolUsage().bytes
+            + qint64(::Furniture::numberFurniture) * qint64(sizeof(PlanItem));
+
+    const ImageCache::Usage images = ImageCache::usage();
+    snapshot.entries[Pixmaps].count = images.pixmaps;
+    snapshot.entries[Pixmaps].bytes = images.pixmapBytes;
+    snapshot.entries[Sprites].count = images.sprites;
+    snapshot.entries[Sprites].bytes = images.spriteBytes;
+    snapshot.entries[Brushes].count = images.brushes;
+    snapshot.entries[Brushes].bytes = images.brushBytes;
+
+    if (!qApp)
+        return snapshot;
+
+    for (QWidget *window : QApplication::topLevelWidgets()) {
+        if (!isCounted(window))
+            continue;
+
+        Entry &windows = snapshot.entries[Windows];
+        windows.count++;
+        snapshot.windowClasses[window->metaObject()->className()]++;
+        if (!window->isVisible())
+            snapshot.hiddenWindows++;
+
+        /* A window shown once keeps its backing store, 32 bits a pixel */
+        if (window->testAttribute(Qt::WA_WState_Created)) {
+            const qreal ratio = window->devicePixelRatioF();
+            windows.bytes += qint64(window->width() * ratio) * qint64(window->height() * ratio) * 4;
+        }
+
+        Entry &widgets = snapshot.entries[Widgets];
+        const int children = window->findChildren<QWidget*>().size();
+        widgets.count += children;
+        widgets.bytes += qint64(children) * sizeof(QWidget);
+    }
+    return snapshot;
+}
+
+/* Assets first, their images are only unshared once they let go */
+void MemoryStats::trim()
+{
+    FurnitureAsset::trim();
+    ImageCache::trim();
+    ::Furniture::trimPool();
+}
+
+QVector<MemoryStats::Kind> MemoryStats::growth(const Snapshot &before, const Snapshot &after)
+{
+    QVector<Kind> kinds;
+    for (int i = 0; i < KindCount; i++) {
+        const Entry &was = before.entries[i];
+        const Entry &now = after.entries[i];
+        if (now.count > was.count || now.bytes - was.bytes > GrowthSlack)
+            kinds.append(Kind(i));
+    }
+    return kinds;
+}
+
+QString MemoryStats::kindName(Kind kind)
+{
+    switch (kind) {
+        case Rooms:     return "Rooms";
+        case Furniture: return "Furniture";
+        case Pixmaps:   return "Images";
+        case Sprites:   return "Sprites";
+        case Brushes:   return "Floor brushes";
+        case Windows:   return "Windows";
+        case Widgets:   return "Widgets";
+        default:        return QString();
+    }
+}
+
+static QString kilobytes(qint64 bytes)
+{
+    return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+}
+
+QString MemoryStats::report(const Snapshot &snapshot, const Snapshot *before)
+{
+    const QVector<Kind> grown = before ? growth(*before, snapshot) : QVector<Kind>();
+
+    QStringList lines;
+    for (int i = 0; i < KindCount; i++) {
+        const Entry &entry = snapshot.entries[i];
+        QString line = QString("%1: %2, %3").arg(kindName(Kind(i))).arg(entry.count).arg(kilobytes(entry.bytes));
+
+        if (before) {
+            const Entry &was = before->entries[i];
+            line += QString(" (%1%2, %3%4)")
+                    .arg(entry.count >= was.count ? "+" : "").arg(entry.count - was.count)
+                    .arg(entry.bytes >= was.bytes ? "+" : "-").arg(kilobytes(qAbs(entry.bytes - was.bytes)));
+            if (grown.contains(Kind(i)))
+                line += " grew";
+        }
+        lines.append(line);
+    }
+    return lines.join('\n');
+}
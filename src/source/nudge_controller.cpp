@@ -0,0 +1,226 @@
+#include <QGraphicsItem>
+#include <QGuiApplication>
+#include <QKeyEvent>
+#include <algorithm>
+#include <cmath>
+
+#include "../headers/nudge_controller.hpp"
+#include "../headers/plan_scene.hpp"
+#include "../headers/furniture.hpp"
+#include "../headers/room.hpp"
+
+/* Enough for a long session, old samples make way for new ones */
+static const int MaxSamples = 10000;
+
+NudgeController::NudgeController(PlanScene *scene)
+    : QObject(scene), m_scene(scene), m_mode(Smooth), m_keys(0), m_speed(0),
+      m_probing(false), m_reportOnExit(false)
+{
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    m_frameTimer.setInterval(m_settings.frameInterval);
+    connect(&m_frameTimer, &QTimer::timeout, this, &NudgeController::tick);
+
+    if (qEnvironmentVariableIsSet("HOMEPLANNER_LATENCY")) {
+        m_reportOnExit = true;
+        if (qgetenv("HOMEPLANNER_LATENCY") == "immediate")
+            m_mode = Immediate;
+    }
+}
+
+NudgeController::~NudgeController()
+{
+    if (m_reportOnExit && !m_samples.isEmpty())
+        qInfo("%s", qPrintable(latencyReport()));
+}
+
+NudgeController::Settings NudgeController::settings() const
+{
+    return m_settings;
+}
+
+void NudgeController::setSettings(const Settings &settings)
+{
+    m_settings = settings;
+    m_frameTimer.setInterval(m_settings.frameInterval);
+}
+
+NudgeController::Mode NudgeController::mode() const
+{
+    return m_mode;
+}
+
+void NudgeController::setMode(Mode mode)
+{
+    stop();
+    m_mode = mode;
+}
+
+int NudgeController::keyBit(int key)
+{
+    switch (key) {
+        case Qt::Key_Left:  return 1;
+        case Qt::Key_Right: return 2;
+        case Qt::Key_Up:    return 4;
+        case Qt::Key_Down:  return 8;
+    }
+    return 0;
+}
+
+QPointF NudgeController::direction(int keys)
+{
+    QPointF d;
+    if (keys & 1) d.rx() -= 1;
+    if (keys & 2) d.rx() += 1;
+    if (keys & 4) d.ry() -= 1;
+    if (keys & 8) d.ry() += 1;
+    return d;
+}
+
+bool NudgeController::isFast() const
+{
+    return QGuiApplication::keyboardModifiers() & Qt::ShiftModifier;
+}
+
+/* Only the focused item moves, as it did before gliding, whatever else
+ * is selected */
+QVector<QGraphicsItem*> NudgeController::targets() const
+{
+    QVector<QGraphicsItem*> items;
+    QGraphicsItem *focused = m_scene->focusItem();
+    if (focused && (focused->type() == Room::Type || focused->type() == Furniture::Type))
+        items.append(focused);
+    return items;
+}
+
+bool NudgeController::keyPressed(QGraphicsItem *item, QKeyEvent *event)
+{
+    const int bit = keyBit(event->key());
+    if (!bit)
+        return false;
+
+    if (!m_probing) {
+        m_probe.start();
+        m_probing = true;
+    }
+
+    const qreal step = event->modifiers() & Qt::ShiftModifier ? m_settings.step * m_settings.fastFactor
+                                                              : m_settings.step;
+
+    const QPointF d = direction(bit) * step;
+
+    /* What every auto-repeat event used to do */
+    if (m_mode == Immediate) {
+        item->moveBy(d.x(), d.y());
+        return true;
+    }
+
+    if (event->isAutoRepeat())
+        return true;
+
+    const bool starting = m_keys == 0;
+    m_keys |= bit;
+
+    /* A tap moves by exactly one step */
+    m_scene->moveItems(targets(), d.x(), d.y());
+
+    if (starting) {
+        m_heldTime.start();
+        m_frameClock.start();
+        m_speed = 0;
+        m_remainder = QPointF();
+        m_frameTimer.start();
+    }
+    return true;
+}
+
+bool NudgeController::keyReleased(QKeyEvent *event)
+{
+    const int bit = keyBit(event->key());
+    if (!bit)
+        return false;
+
+    /* Auto-repeat comes as release and press pairs on some platforms */
+    if (event->isAutoRepeat())
+        return true;
+
+    m_keys &= ~bit;
+    if (m_keys == 0)
+        stop();
+    return true;
+}
+
+void NudgeController::stop()
+{
+    m_frameTimer.stop();
+    m_keys = 0;
+    m_speed = 0;
+    m_remainder = QPointF();
+}
+
+void NudgeController::tick()
+{
+    /* Releases are lost when focus moves away while a key is held */
+    if (m_keys == 0 || !m_scene->hasFocus()) {
+        stop();
+        return;
+    }
+
+    const qreal seconds = m_frameClock.restart() / 1000.0;
+    if (m_heldTime.elapsed() < m_settings.holdDelay)
+        return;
+
+    m_speed = m_speed == 0 ? m_settings.startSpeed
+                           : qMin(m_settings.maxSpeed, m_speed + m_settings.acceleration * seconds);
+    const qreal factor = isFast() ? m_settings.fastFactor : 1;
+
+    /* Whole pixels only, so items stay on the grid taps put them on */
+    const QPointF d = direction(m_keys) * (m_speed * factor * seconds) + m_remainder;
+    const QPointF whole(std::trunc(d.x()), std::trunc(d.y()));
+    m_remainder = d - whole;
+
+    if (!whole.isNull())
+        m_scene->moveItems(targets(), whole.x(), whole.y());
+}
+
+void NudgeController::framePainted()
+{
+    if (!m_probing)
+        return;
+
+    m_probing = false;
+    if (m_samples.size() >= MaxSamples)
+        m_samples.remove(0, MaxSamples / 2);
+    m_samples.append(m_probe.nsecsElapsed() / 1e6);
+}
+
+NudgeController::LatencyStats NudgeController::latency() const
+{
+    LatencyStats stats;
+    if (m_samples.isEmpty())
+        return stats;
+
+    QVector<double> sorted = m_samples;
+    std::sort(sorted.begin(), sorted.end());
+    stats.samples = sorted.size();
+    stats.median = sorted.at(sorted.size() / 2);
+    stats.p95 = sorted.at(qMin(sorted.size() - 1, sorted.size() * 95 / 100));
+    stats.max = sorted.last();
+    return stats;
+}
+
+void NudgeController::resetLatency()
+{
+    m_samples.clear();
+    m_probing = false;
+}
+
+QString NudgeController::latencyReport() const
+{
+    const LatencyStats stats = latency();
+    return QString("Key to frame latency (%1): %2 samples, median %3 ms, 95th percentile %4 ms, max %5 ms")
+            .arg(m_mode == Smooth ? "smooth" : "immediate")
+            .arg(stats.samples)
+            .arg(stats.median, 0, 'f', 2)
+            .arg(stats.p95, 0, 'f', 2)
+            .arg(stats.max, 0, 'f', 2);
+}
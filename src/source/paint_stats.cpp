@@ -0,0 +1,104 @@
+#include <QElapsedTimer>
+#include <atomic>
+
+#include "../headers/paint_stats.hpp"
+
+struct StatsTable
+{
+    StatsTable()
+        : users(0), indexStart(-1), cacheHits(0), cacheMisses(0)
+    {
+        for (int i = 0; i < PaintStats::KindCount; i++) {
+            nsecs[i] = 0;
+            counts[i] = 0;
+        }
+        clock.start();
+    }
+
+    std::atomic<int> users;
+    QElapsedTimer clock;
+    std::atomic<qint64> indexStart;
+    std::atomic<qint64> nsecs[PaintStats::KindCount];
+    std::atomic<int> counts[PaintStats::KindCount];
+    std::atomic<int> cacheHits;
+    std::atomic<int> cacheMisses;
+};
+
+static StatsTable &statsTable()
+{
+    static StatsTable table;
+    return table;
+}
+
+bool PaintStats::isEnabled()
+{
+    return statsTable().users.load(std::memory_order_relaxed) > 0;
+}
+
+void PaintStats::setEnabled(bool enabled)
+{
+    if (enabled)
+        statsTable().users++;
+    else
+        statsTable().users--;
+}
+
+qint64 PaintStats::now()
+{
+    return statsTable().clock.nsecsElapsed();
+}
+
+qint64 PaintStats::begin(Kind kind)
+{
+    if (!isEnabled())
+        return -1;
+
+    /* The first item painted ends the index lookup */
+    if (kind == RoomPaint || kind == FurniturePaint)
+        indexQueryFinished();
+    return now();
+}
+
+void PaintStats::add(Kind kind, qint64 nsecs)
+{
+    StatsTable &table = statsTable();
+    table.nsecs[kind] += nsecs;
+    table.counts[kind]++;
+}
+
+void PaintStats::cacheLookup(bool hit)
+{
+    if (!isEnabled())
+        return;
+    if (hit)
+        statsTable().cacheHits++;
+    else
+        statsTable().cacheMisses++;
+}
+
+void PaintStats::indexQueryStarted()
+{
+    if (isEnabled())
+        statsTable().indexStart = now();
+}
+
+void PaintStats::indexQueryFinished()
+{
+    const qint64 start = statsTable().indexStart.exchange(-1);
+    if (start >= 0)
+        add(IndexQuery, now() - start);
+}
+
+PaintStats::Frame PaintStats::takeFrame()
+{
+    StatsTable &table = statsTable();
+
+    Frame frame;
+    for (int i = 0; i < KindCount; i++) {
+        frame.nsecs[i] = table.nsecs[i].exchange(0);
+        frame.counts[i] = table.counts[i].exchange(0);
+    }
+    frame.cacheHits = table.cacheHits.exchange(0);
+    frame.cacheMisses = table.cacheMisses.exchange(0);
+    return frame;
+}
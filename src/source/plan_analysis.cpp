@@ -0,0 +1,110 @@
+#include <QJsonArray>
+#include <QStringList>
+#include <algorithm>
+
+#include "../headers/plan_analysis.hpp"
+#include "../headers/plan_geometry.hpp"
+
+namespace {
+
+using PlanGeometry::Quad;
+
+/* Sweeps over the items sorted by their left edge, so only items whose
+ * bounding rects share some x range are compared */
+void findOverlaps(QVector<Quad> &quads, QVector<PlanIssue> &issues)
+{
+    std::sort(quads.begin(), quads.end(), [](const Quad &a, const Quad &b) {
+        return a.bounds.left() < b.bounds.left();
+    });
+
+    for (int i = 0; i < quads.size(); i++) {
+        for (int j = i + 1; j < quads.size(); j++) {
+            if (quads[j].bounds.left() >= quads[i].bounds.right())
+                break;
+            if (quads[i].bounds.intersects(quads[j].bounds)
+                    && PlanGeometry::overlaps(quads[i], quads[j]))
+                issues.append({ PlanIssue::Overlap, quads[i].id, quads[j].id });
+        }
+    }
+}
+
+}
+
+bool PlanReport::isValid() const
+{
+    return issues.isEmpty();
+}
+
+QJsonObject PlanReport::toJson() const
+{
+    QJsonObject counts;
+    for (auto it = categories.constBegin(); it != categories.constEnd(); ++it)
+        counts[it.key()] = it.value();
+
+    QJsonArray overlaps, outside;
+    for (const PlanIssue &issue : issues) {
+        if (issue.type == PlanIssue::Overlap)
+            overlaps.append(QJsonArray({ double(issue.first), double(issue.second) }));
+        else
+            outside.append(double(issue.first));
+    }
+
+    QJsonObject object;
+    object["valid"] = isValid();
+    object["rooms"] = rooms;
+    object["furniture"] = furniture;
+    object["area"] = area;
+    object["categories"] = counts;
+    object["overlaps"] = overlaps;
+    object["outsideRooms"] = outside;
+    return object;
+}
+
+QString PlanAnalysis::categoryOf(const QString &urlPath)
+{
+    /* Not split with SkipEmptyParts, whose enum moved in Qt 5.14 */
+    QStringList parts = urlPath.split('/');
+    parts.removeAll(QString());
+    const int furniture = parts.indexOf("furniture");
+
+    if (furniture >= 0 && furniture + 2 < parts.size())
+        return parts.at(furniture + 1);
+    return "other";
+}
+
+PlanReport PlanAnalysis::analyze(const QVector<PlanRecord> &records)
+{
+    PlanReport report;
+    QVector<Quad> rooms, furniture;
+
+    for (const PlanRecord &record : records) {
+        if (record.kind == PlanRecord::RoomKind) {
+            report.rooms++;
+            report.area += record.width * record.height
+                           / (PlanGeometry::PixelsPerMeter * PlanGeometry::PixelsPerMeter);
+            rooms.append(PlanGeometry::quad(record));
+        }
+        else {
+            report.furniture++;
+            report.categories[categoryOf(record.urlPath)]++;
+            furniture.append(PlanGeometry::quad(record));
+        }
+    }
+
+    /* Every corner has to be in some room, not necessarily the same one */
+    for (const Quad &piece : furniture) {
+        for (const QPointF &corner : piece.corners) {
+            auto inRoom = [&corner](const Quad &room) {
+                return PlanGeometry::contains(room, corner);
+            };
+            if (std::none_of(rooms.constBegin(), rooms.constEnd(), inRoom)) {
+                report.issues.append({ PlanIssue::OutsideRooms, piece.id, 0 });
+                break;
+            }
+        }
+    }
+
+    findOverlaps(rooms, report.issues);
+    findOverlaps(furniture, report.issues);
+    return report;
+}
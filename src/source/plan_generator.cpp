@@ -0,0 +1,365 @@
+#include <QRandomGenerator>
+#include <QRectF>
+#include <QtMath>
+#include <algorithm>
+
+#include "../headers/plan_generator.hpp"
+
+/* 33 px make one meter, like in DesignWindow */
+static const qreal Meter = 33;
+
+/* Pieces keep this far from walls and from each other */
+static const qreal Gap = 2;
+
+/* Random spots tried per piece before it is left out */
+static const int Attempts = 40;
+
+namespace {
+
+enum Purpose { Living, Kitchen, Bedroom, Bathroom, Hall, Office, Meeting };
+
+enum Placement {
+    AgainstWall,    // Back to a wall, facing into the room
+    Free,           // Anywhere, tables and chairs
+    Floor           // Carpets, other pieces may stand on them
+};
+
+struct Piece
+{
+    const char *image;      // Under :/img/furniture/
+    int width;
+    int height;
+    int min;                // Pieces of this kind per room, before density
+    int max;
+    Placement placement;
+};
+
+struct PurposeKit
+{
+    QVector<const char*> floors;
+    QVector<Piece> pieces;
+};
+
+/* Sizes are the ones the catalog buttons of TemplateWindow use */
+const PurposeKit &kit(Purpose purpose)
+{
+    static const PurposeKit kits[] = {
+        /* Living */
+        { { "floor/floor_light_3.jpg", "floor/floor_light_1.jpg", "floor/floor_beige.jpg", "floor/floor_dark.jpg" },
+          { { "other/carpet_2_colorful_1.png", 40, 30, 0, 1, Floor },
+            { "sofas/corner_sofa_1_black.png", 60, 50, 0, 1, AgainstWall },
+            { "sofas/sofa_1_light_blue.png", 50, 30, 1, 1, AgainstWall },
+            { "tables/tv_stand_table_1_brown.png", 55, 13, 1, 1, AgainstWall },
+            { "armchairs/armchair_1_white.png", 25, 25, 0, 2, Free },
+            { "tables/glass_table.png", 35, 20, 1, 1, Free },
+            { "other/shelf_dark.png", 50, 7, 0, 1, AgainstWall },
+            { "other/fireplace.png", 45, 20, 0, 1, AgainstWall },
+            { "other/piano_black.png", 30, 10, 0, 1, AgainstWall },
+            { "other/plant.png", 18, 18, 0, 2, AgainstWall },
+            { "other/lamp_1.png", 12, 12, 0, 2, AgainstWall } } },
+        /* Kitchen */
+        { { "floor/tiles_beige.jpg", "floor/tiles_grey.jpg", "floor/tiles_white_2.jpg" },
+          { { "kitchen/bottom_cabinet_2.png", 30, 24, 1, 3, AgainstWall },
+            { "kitchen/stove.png", 24, 24, 1, 1, AgainstWall },
+            { "sinks/sink_3.png", 35, 15, 1, 1, AgainstWall },
+            { "electronic devices/fridge_white.png", 25, 25, 1, 1, AgainstWall },
+            { "tables/table_5_complete_brown.png", 50, 50, 0, 1, Free },
+            { "tables/table_3_round_light_wood.png", 25, 25, 0, 1, Free },
+            { "chairs/chair_3_light.png", 15, 18, 0, 3, Free },
+            { "other/bin.png", 17, 14, 0, 1, AgainstWall } } },
+        /* Bedroom */
+        { { "floor/floor_light_2.jpg", "floor/floor_light_4.jpg", "floor/floor_light_5.jpg", "floor/floor_grey.jpeg" },
+          { { "other/carpet_1_brown.png", 35, 35, 0, 1, Floor },
+            { "beds/king_bed_1_white.png", 38, 50, 0, 1, AgainstWall },
+            { "beds/single_bed_white.png", 40, 25, 0, 2, AgainstWall },
+            { "wardrobes & cabinets/night_table_1_normal.png", 20, 15, 1, 2, AgainstWall },
+            { "wardrobes & cabinets/wardrobe_1_normal.png", 45, 20, 1, 1, AgainstWall },
+            { "wardrobes & cabinets/cabinet_1_light.png", 23, 18, 0, 1, AgainstWall },
+            { "tables/table_4_light_wood.png", 40, 25, 0, 1, AgainstWall },
+            { "chairs/chair_1_grey.png", 20, 20, 0, 1, Free },
+            { "other/lamp_2.png", 11, 11, 0, 1, AgainstWall } } },
+        /* Bathroom */
+        { { "floor/tiles_white_1.jpg", "floor/tiles_white_3.jpg", "floor/tiles_lightgrey.jpg" },
+          { { "bathroom/bath_2.png", 40, 25, 0, 1, AgainstWall },
+            { "bathroom/shower_1.png", 30, 25, 0, 1, AgainstWall },
+            { "bathroom/toilet_1.png", 12, 20, 1, 1, AgainstWall },
+            { "bathroom/sink_1.png", 20, 15, 1, 1, AgainstWall },
+            { "electronic devices/washing_machine_white.png", 25, 20, 0, 1, AgainstWall },
+            { "bathroom/cabinet.png", 15, 15, 0, 1, AgainstWall } } },
+        /* Hall */
+        { { "floor/tiles_light_grey.jpeg", "floor/floor_light_6.jpg" },
+          { { "wardrobes & cabinets/cabinet_3_dark.png", 17, 17, 0, 1, AgainstWall },
+            { "other/shelf_light.png", 50, 7, 0, 1, AgainstWall },
+            { "other/plant.png", 18, 18, 0, 1, AgainstWall } } },
+        /* Office */
+        { { "floor/floor_grey.jpeg", "floor/tiles_grey.jpg" },
+          { { "tables/table_1_white.png", 50, 25, 1, 4, AgainstWall },
+            { "chairs/chair_1_black.png", 20, 20, 1, 4, Free },
+            { "electronic devices/pc.png", 22, 12, 0, 2, AgainstWall },
+            { "wardrobes & cabinets/cabinet_1_white.png", 23, 18, 0, 2, AgainstWall },
+            { "other/plant.png", 18, 18, 0, 2, AgainstWall },
+            { "other/bin.png", 17, 14, 0, 1, AgainstWall } } },
+        /* Meeting */
+        { { "floor/floor_dark.jpg", "floor/floor_grey.jpeg" },
+          { { "tables/table_7_dark.png", 50, 30, 1, 1, Free },
+            { "chairs/chair_2_dark.png", 15, 18, 4, 8, Free },
+            { "electronic devices/tv_1_black.png", 33, 7, 0, 1, AgainstWall },
+            { "other/plant.png", 18, 18, 0, 2, AgainstWall } } },
+    };
+    return kits[purpose];
+}
+
+const char *const Doors[] = {
+    "doors/doors_1.png", "doors/doors_2.png", "doors/doors_3.png",
+    "doors/doors_4.png", "doors/doors_5.png", "doors/doors_6.png"
+};
+
+QString imagePath(const char *image)
+{
+    return QStringLiteral(":/img/furniture/") + QLatin1String(image);
+}
+
+/* Average room size of a layout, in square meters */
+qreal roomArea(PlanGenerator::Layout layout)
+{
+    switch (layout) {
+        case PlanGenerator::Apartment:  return 14;
+        case PlanGenerator::House:      return 16;
+        case PlanGenerator::Office:     return 18;
+    }
+    return 14;
+}
+
+/* Cuts the largest piece of the floor in two, across its longer side,
+ * until there are as many pieces as rooms */
+QVector<QRectF> splitFloor(const QSizeF &floor, int rooms, QRandomGenerator &random)
+{
+    QVector<QRectF> pieces { QRectF(QPointF(0, 0), floor) };
+
+    while (pieces.size() < rooms) {
+        auto largest = std::max_element(pieces.begin(), pieces.end(), [](const QRectF &a, const QRectF &b) {
+            return a.width() * a.height() < b.width() * b.height();
+        });
+        const QRectF piece = *largest;
+        const qreal ratio = 0.35 + random.bounded(0.3);
+
+        QRectF first = piece;
+        QRectF second = piece;
+        if (piece.width() >= piece.height()) {
+            const qreal cut = qRound(piece.left() + piece.width() * ratio);
+            first.setRight(cut);
+            second.setLeft(cut);
+        }
+        else {
+            const qreal cut = qRound(piece.top() + piece.height() * ratio);
+            first.setBottom(cut);
+            second.setTop(cut);
+        }
+        *largest = first;
+        pieces.append(second);
+    }
+    return pieces;
+}
+
+/* Largest rooms become living and meeting rooms, the smallest ones
+ * bathrooms and halls, everything else what the layout is made of */
+QVector<Purpose> purposes(const QVector<QRectF> &rooms, PlanGenerator::Layout layout)
+{
+    QVector<int> bySize(rooms.size());
+    for (int i = 0; i < bySize.size(); i++)
+        bySize[i] = i;
+    std::sort(bySize.begin(), bySize.end(), [&rooms](int a, int b) {
+        return rooms.at(a).width() * rooms.at(a).height() > rooms.at(b).width() * rooms.at(b).height();
+    });
+
+    const int count = rooms.size();
+    const bool office = layout == PlanGenerator::Office;
+    QVector<Purpose> result(count, office ? Office : Bedroom);
+
+    int largest = 0;
+    int smallest = count - 1;
+    auto takeLargest = [&](Purpose purpose, int n) {
+        for (int i = 0; i < n && largest <= smallest; i++)
+            result[bySize.at(largest++)] = purpose;
+    };
+    auto takeSmallest = [&](Purpose purpose, int n) {
+        for (int i = 0; i < n && largest <= smallest; i++)
+            result[bySize.at(smallest--)] = purpose;
+    };
+
+    if (office) {
+        takeLargest(Meeting, qMax(1, count / 8));
+        takeSmallest(Bathroom, qMax(1, count / 10));
+        takeSmallest(Kitchen, count >= 4 ? qMax(1, count / 12) : 0);
+    }
+    else {
+        const int bathEvery = layout == PlanGenerator::House ? 3 : 4;
+        takeLargest(Living, qMax(1, count / 10));
+        takeLargest(Kitchen, count >= 2 ? qMax(1, count / 10) : 0);
+        takeSmallest(Bathroom, count >= 3 ? qMax(1, count / bathEvery) : 0);
+        takeSmallest(Hall, count >= 5 ? qMax(1, count / 6) : 0);
+    }
+    return result;
+}
+
+/* Places furniture in one room, keeping track of what is taken */
+class RoomFurnisher
+{
+public:
+    RoomFurnisher(const QRectF &room, QRandomGenerator &random, QVector<PlanRecord> &out)
+        : m_inside(room.adjusted(Gap, Gap, -Gap, -Gap)), m_random(random), m_out(out)
+    {
+    }
+
+    void place(const QString &image, int width, int height, Placement placement, qreal zValue)
+    {
+        for (int attempt = 0; attempt < Attempts; attempt++) {
+            int angle;
+            QRectF footprint;
+            if (placement == AgainstWall) {
+                /* 0 puts the back to the top wall, then clockwise */
+                angle = 90 * int(m_random.bounded(4));
+                footprint = wallSpot(angle, width, height);
+            }
+            else {
+                angle = m_random.bounded(2) ? 90 : 0;
+                footprint = freeSpot(angle, width, height);
+            }
+
+            if (!m_inside.contains(footprint) || !isFree(footprint, placement))
+                continue;
+
+            (placement == Floor ? m_floor : m_taken).append(footprint.adjusted(-Gap, -Gap, Gap, Gap));
+
+            /* Records keep the unrotated rect, rotation is around its center */
+            PlanRecord record;
+            record.kind = PlanRecord::FurnitureKind;
+            record.urlPath = image;
+            record.width = width;
+            record.height = height;
+            record.x = footprint.center().x() - width / 2.0;
+            record.y = footprint.center().y() - height / 2.0;
+            record.angle = angle;
+            record.zValue = zValue;
+            m_out.append(record);
+            return;
+        }
+    }
+
+private:
+    QSizeF turned(int angle, int width, int height) const
+    {
+        return angle % 180 ? QSizeF(height, width) : QSizeF(width, height);
+    }
+
+    QRectF wallSpot(int angle, int width, int height) const
+    {
+        const QSizeF size = turned(angle, width, height);
+        const qreal alongX = m_inside.left() + m_random.bounded(qMax(1.0, m_inside.width() - size.width()));
+        const qreal alongY = m_inside.top() + m_random.bounded(qMax(1.0, m_inside.height() - size.height()));
+
+        switch (angle) {
+            case 0:   return QRectF(QPointF(alongX, m_inside.top()), size);
+            case 90:  return QRectF(QPointF(m_inside.right() - size.width(), alongY), size);
+            case 180: return QRectF(QPointF(alongX, m_inside.bottom() - size.height()), size);
+            default:  return QRectF(QPointF(m_inside.left(), alongY), size);
+        }
+    }
+
+    QRectF freeSpot(int angle, int width, int height) const
+    {
+        const QSizeF size = turned(angle, width, height);
+        const qreal x = m_inside.left() + m_random.bounded(qMax(1.0, m_inside.width() - size.width()));
+        const qreal y = m_inside.top() + m_random.bounded(qMax(1.0, m_inside.height() - size.height()));
+        return QRectF(QPointF(x, y), size);
+    }
+
+    /* Carpets only avoid other carpets, everything else avoids all but carpets */
+    bool isFree(const QRectF &footprint, Placement placement) const
+    {
+        const QVector<QRectF> &others = placement == Floor ? m_floor : m_taken;
+        for (const QRectF &other : others)
+            if (other.intersects(footprint))
+                return false;
+        return true;
+    }
+
+    QRectF m_inside;
+    QRandomGenerator &m_random;
+    QVector<PlanRecord> &m_out;
+    QVector<QRectF> m_taken;
+    QVector<QRectF> m_floor;
+};
+
+int pieceCount(const Piece &piece, qreal density, QRandomGenerator &random)
+{
+    const int base = piece.min + int(random.bounded(piece.max - piece.min + 1));
+    return qRound(base * density);
+}
+
+}
+
+QVector<PlanRecord> PlanGenerator::generate(const Options &options)
+{
+    QRandomGenerator random(options.seed);
+    const int roomCount = qMax(1, options.rooms);
+
+    /* A floor half again as wide as deep, large enough for the rooms */
+    const qreal area = roomCount * roomArea(options.layout) * Meter * Meter;
+    const QSizeF floor(qRound(qSqrt(area * 1.5)), qRound(qSqrt(area / 1.5)));
+    const QVector<QRectF> rooms = splitFloor(floor, roomCount, random);
+    const QVector<Purpose> roomPurposes = purposes(rooms, options.layout);
+
+    QVector<PlanRecord> records;
+    records.reserve(roomCount * 8);
+
+    for (int i = 0; i < rooms.size(); i++) {
+        const PurposeKit &roomKit = kit(roomPurposes.at(i));
+        PlanRecord room;
+        room.kind = PlanRecord::RoomKind;
+        room.urlPath = imagePath(roomKit.floors.at(int(random.bounded(roomKit.floors.size()))));
+        room.x = rooms.at(i).x();
+        room.y = rooms.at(i).y();
+        room.width = rooms.at(i).width();
+        room.height = rooms.at(i).height();
+        room.zValue = -1;
+        records.append(room);
+    }
+
+    for (int i = 0; i < rooms.size(); i++) {
+        RoomFurnisher furnisher(rooms.at(i), random, records);
+
+        /* The door first, so it always finds a wall */
+        const int door = int(random.bounded(int(sizeof(Doors) / sizeof(Doors[0]))));
+        furnisher.place(imagePath(Doors[door]), 20, 30, AgainstWall, 2);
+
+        for (const Piece &piece : kit(roomPurposes.at(i)).pieces) {
+            const int count = pieceCount(piece, options.density, random);
+            for (int n = 0; n < count; n++)
+                furnisher.place(imagePath(piece.image), piece.width, piece.height,
+                                piece.placement, piece.placement == Floor ? 0 : 1);
+        }
+    }
+    return records;
+}
+
+bool PlanGenerator::layoutFromName(const QString &name, Layout *layout)
+{
+    for (Layout candidate : { Apartment, House, Office }) {
+        if (name.compare(layoutName(candidate), Qt::CaseInsensitive) == 0) {
+            *layout = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+QString PlanGenerator::layoutName(Layout layout)
+{
+    switch (layout) {
+        case Apartment: return "apartment";
+        case House:     return "house";
+        case Office:    return "office";
+    }
+    return QString();
+}
@@ -0,0 +1,84 @@
+#include <QtMath>
+
+#include "../headers/plan_geometry.hpp"
+
+PlanGeometry::Quad PlanGeometry::quad(quint64 id, qreal x, qreal y,
+                                      qreal width, qreal height, qreal angle)
+{
+    Quad quad;
+    quad.id = id;
+
+    const qreal rad = qDegreesToRadians(angle);
+    const qreal c = qCos(rad);
+    const qreal s = qSin(rad);
+    const QPointF center(x + width / 2, y + height / 2);
+    const QPointF local[4] = {
+        QPointF(-width / 2, -height / 2),
+        QPointF( width / 2, -height / 2),
+        QPointF( width / 2,  height / 2),
+        QPointF(-width / 2,  height / 2)
+    };
+
+    qreal left = 1e300, top = 1e300, right = -1e300, bottom = -1e300;
+    for (int i = 0; i < 4; i++) {
+        const QPointF corner = center + QPointF(local[i].x() * c - local[i].y() * s,
+                                                local[i].x() * s + local[i].y() * c);
+        quad.corners[i] = corner;
+        left = qMin(left, corner.x());   right = qMax(right, corner.x());
+        top = qMin(top, corner.y());     bottom = qMax(bottom, corner.y());
+    }
+
+    quad.bounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+    return quad;
+}
+
+PlanGeometry::Quad PlanGeometry::quad(const PlanRecord &record)
+{
+    return quad(record.id, record.x, record.y, record.width, record.height, record.angle);
+}
+
+/* Separating axis test, the edges of both rectangles are the only candidate axes */
+bool PlanGeometry::overlaps(const Quad &a, const Quad &b)
+{
+    const Quad *quads[2] = { &a, &b };
+
+    for (const Quad *quad : quads) {
+        for (int i = 0; i < 2; i++) {
+            const QPointF edge = quad->corners[i + 1] - quad->corners[i];
+            const qreal length = qSqrt(QPointF::dotProduct(edge, edge));
+            if (qFuzzyIsNull(length))
+                return false;
+            const QPointF axis(-edge.y() / length, edge.x() / length);
+
+            qreal minA = 1e300, maxA = -1e300, minB = 1e300, maxB = -1e300;
+            for (int k = 0; k < 4; k++) {
+                const qreal pa = QPointF::dotProduct(a.corners[k], axis);
+                const qreal pb = QPointF::dotProduct(b.corners[k], axis);
+                minA = qMin(minA, pa); maxA = qMax(maxA, pa);
+                minB = qMin(minB, pb); maxB = qMax(maxB, pb);
+            }
+
+            if (maxA - minB <= Tolerance || maxB - minA <= Tolerance)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool PlanGeometry::contains(const Quad &quad, const QPointF &point)
+{
+    if (!quad.bounds.adjusted(-Tolerance, -Tolerance, Tolerance, Tolerance).contains(point))
+        return false;
+
+    for (int i = 0; i < 4; i++) {
+        const QPointF edge = quad.corners[(i + 1) % 4] - quad.corners[i];
+        const QPointF toPoint = point - quad.corners[i];
+        const qreal cross = edge.x() * toPoint.y() - edge.y() * toPoint.x();
+        const qreal length = qSqrt(QPointF::dotProduct(edge, edge));
+
+        /* Clockwise corners with y growing downwards, inside is on the right */
+        if (cross < -Tolerance * length)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,301 @@
+#include <QTimer>
+#include <algorithm>
+#include <numeric>
+
+#include "../headers/plan_history.hpp"
+
+/* Operations undone by restoring a recorded state of the item */
+static bool isEdit(PlanOp::Type type)
+{
+    return type != PlanOp::Add && type != PlanOp::Delete;
+}
+
+bool PlanChange::sameItems(const PlanChange &other) const
+{
+    if (after.size() != other.after.size())
+        return false;
+
+    for (int i = 0; i < after.size(); i++)
+        if (after.at(i).id != other.after.at(i).id)
+            return false;
+    return true;
+}
+
+/* Rough, but proportional to what the entry really keeps alive */
+qint64 PlanChange::memoryUsage() const
+{
+    qint64 bytes = sizeof(PlanChange);
+    for (const PlanRecord &record : before)
+        bytes += sizeof(PlanRecord) + record.urlPath.size() * sizeof(QChar);
+    for (const PlanRecord &record : after)
+        bytes += sizeof(PlanRecord) + record.urlPath.size() * sizeof(QChar);
+    return bytes;
+}
+
+/* One entry of the undo stack. Changes are recorded after they happened,
+ * so the first redo, done by QUndoStack::push, has nothing to do. */
+class PlanCommand : public QUndoCommand
+{
+public:
+    PlanCommand(PlanHistory *history, const QSharedPointer<PlanChange> &change, bool done)
+        : m_history(history), m_change(change), m_done(done)
+    {
+        setText(describe());
+    }
+
+    void undo() override
+    {
+        m_history->apply(*m_change, true);
+    }
+
+    void redo() override
+    {
+        if (m_done) {
+            m_done = false;
+            return;
+        }
+        m_history->apply(*m_change, false);
+    }
+
+    /* Only moves and rotations merge, everything else stays its own step */
+    int id() const override
+    {
+        if (m_change->type == PlanOp::Move || m_change->type == PlanOp::Rotate)
+            return m_change->type;
+        return -1;
+    }
+
+    bool mergeWith(const QUndoCommand *other) override
+    {
+        if (m_history->m_rebuilding)
+            return false;
+
+        const PlanChange &next = *static_cast<const PlanCommand*>(other)->m_change;
+        if (next.type != m_change->type || !m_change->sameItems(next)
+                || next.time - m_change->time > PlanHistory::MergeInterval)
+            return false;
+
+        m_change->after = next.after;
+        m_change->time = next.time;
+        return true;
+    }
+
+    QSharedPointer<PlanChange> change() const
+    {
+        return m_change;
+    }
+
+private:
+    QString describe() const
+    {
+        const int count = m_change->after.size();
+        const QString items = count == 1 ? "item" : QString("%1 items").arg(count);
+
+        switch (m_change->type) {
+            case PlanOp::Add:    return "Add " + items;
+            case PlanOp::Move:   return "Move " + items;
+            case PlanOp::Rotate: return "Rotate " + items;
+            case PlanOp::Flip:   return "Flip " + items;
+            case PlanOp::Delete: return "Delete " + items;
+            case PlanOp::Floor:  return "Change floor";
+        }
+        return QString();
+    }
+
+    PlanHistory *m_history;
+    QSharedPointer<PlanChange> m_change;
+    bool m_done;
+};
+
+PlanHistory::PlanHistory(PlanScene *scene, QObject *parent)
+    : QObject(parent), m_scene(scene), m_memoryUsage(0),
+      m_memoryLimit(DefaultMemoryLimit), m_recording(true), m_applying(false),
+      m_rebuilding(false)
+{
+    m_clock.start();
+    reset();
+    connect(m_scene, &PlanScene::planChanged, this, &PlanHistory::record);
+}
+
+QUndoStack *PlanHistory::stack()
+{
+    return &m_stack;
+}
+
+void PlanHistory::reset()
+{
+    m_pending.reset();
+    m_pendingIndex.clear();
+    m_stack.clear();
+    m_memoryUsage = 0;
+
+    m_known.clear();
+    const QVector<PlanRecord> records = m_scene->model().records();
+    m_known.reserve(records.size());
+    for (const PlanRecord &record : records)
+        m_known.insert(record.id, record);
+}
+
+void PlanHistory::setRecording(bool recording)
+{
+    if (!recording)
+        flush();
+    m_recording = recording;
+}
+
+bool PlanHistory::isRecording() const
+{
+    return m_recording;
+}
+
+qint64 PlanHistory::memoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+qint64 PlanHistory::memoryLimit() const
+{
+    return m_memoryLimit;
+}
+
+void PlanHistory::setMemoryLimit(qint64 bytes)
+{
+    m_memoryLimit = bytes;
+    trim();
+}
+
+void PlanHistory::record(const PlanOp &op)
+{
+    const quint64 id = op.record.id;
+
+    if (m_recording && !m_applying) {
+        /* Adding and deleting never share an entry with anything else.
+         * Edits do, a group rotation both turns and moves its items. */
+        if (m_pending && m_pending->type != op.type
+                && (!isEdit(m_pending->type) || !isEdit(op.type)))
+            flush();
+
+        if (!m_pending) {
+            m_pending = QSharedPointer<PlanChange>::create();
+            m_pending->type = op.type;
+            m_pending->time = m_clock.elapsed();
+            QTimer::singleShot(0, this, &PlanHistory::flush);
+        }
+
+        /* An item changed twice in one pass keeps its first "before" */
+        auto slot = m_pendingIndex.constFind(id);
+        if (slot != m_pendingIndex.constEnd()) {
+            m_pending->after[*slot] = op.record;
+        }
+        else {
+            m_pendingIndex.insert(id, m_pending->after.size());
+            m_pending->before.append(op.type == PlanOp::Add ? op.record : m_known.value(id, op.record));
+            m_pending->after.append(op.record);
+        }
+    }
+
+    if (op.type == PlanOp::Delete)
+        m_known.remove(id);
+    else
+        m_known.insert(id, op.record);
+}
+
+void PlanHistory::flush()
+{
+    if (!m_pending)
+        return;
+
+    QSharedPointer<PlanChange> change = m_pending;
+    m_pending.reset();
+    m_pendingIndex.clear();
+
+    /* Sorted by id, so merging only has to compare two lists */
+    QVector<int> order(change->after.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&change](int a, int b) {
+        return change->after.at(a).id < change->after.at(b).id;
+    });
+
+    QVector<PlanRecord> before, after;
+    before.reserve(order.size());
+    after.reserve(order.size());
+    for (int i : order) {
+        before.append(change->before.at(i));
+        after.append(change->after.at(i));
+    }
+    change->before = before;
+    change->after = after;
+
+    /* Pushing drops everything that could have been redone */
+    for (int i = m_stack.index(); i < m_stack.count(); i++)
+        m_memoryUsage -= static_cast<const PlanCommand*>(m_stack.command(i))->change()->memoryUsage();
+
+    const int index = m_stack.index();
+    m_stack.push(new PlanCommand(this, change, true));
+    if (m_stack.count() > index)
+        m_memoryUsage += change->memoryUsage();
+
+    trim();
+}
+
+/* Rebuilds the stack from the newest entries once it grew past the limit.
+ * Entries are shared, nothing but the commands themselves gets copied. */
+void PlanHistory::trim()
+{
+    if (m_memoryUsage <= m_memoryLimit)
+        return;
+
+    /* Trimming to half the limit keeps this from running on every push */
+    QVector<QSharedPointer<PlanChange>> kept;
+    qint64 usage = 0;
+    for (int i = m_stack.index() - 1; i >= 0; i--) {
+        QSharedPointer<PlanChange> change = static_cast<const PlanCommand*>(m_stack.command(i))->change();
+        if (usage + change->memoryUsage() > m_memoryLimit / 2)
+            break;
+        usage += change->memoryUsage();
+        kept.prepend(change);
+    }
+
+    m_rebuilding = true;
+    m_stack.clear();
+    for (const QSharedPointer<PlanChange> &change : kept)
+        m_stack.push(new PlanCommand(this, change, true));
+    m_rebuilding = false;
+
+    m_memoryUsage = usage;
+}
+
+void PlanHistory::apply(const PlanChange &change, bool undo)
+{
+    m_applying = true;
+    const QVector<PlanRecord> &target = undo ? change.before : change.after;
+
+    for (const PlanRecord &record : target) {
+        if (change.type == PlanOp::Add || change.type == PlanOp::Delete) {
+            /* Undoing an add or redoing a delete takes the item away */
+            if (undo == (change.type == PlanOp::Add))
+                remove(record.id);
+            else
+                restore(record);
+        }
+        else {
+            m_scene->updateItem(record);
+        }
+    }
+
+    m_applying = false;
+}
+
+void PlanHistory::restore(const PlanRecord &record)
+{
+    if (m_scene->item(record.id))
+        return;
+
+    QGraphicsItem *item = m_scene->addRecord(record);
+    emit itemRestored(item);
+}
+
+void PlanHistory::remove(quint64 id)
+{
+    delete m_scene->item(id);
+}
@@ -0,0 +1,144 @@
+#include <QFontDatabase>
+#include <QPainter>
+#include <QStringList>
+
+#include "../headers/plan_hud.hpp"
+
+/* Upper bounds of the histogram buckets, in milliseconds. 16 and 33 are
+ * one and two frames at 60 Hz. The last bucket takes everything slower. */
+static const double BucketLimits[] = { 4, 8, 16, 33, 66 };
+static const int BucketCount = sizeof(BucketLimits) / sizeof(BucketLimits[0]) + 1;
+
+static const int Margin = 8;
+static const int Padding = 6;
+static const int TextLines = 4;
+static const int HistogramHeight = 48;
+
+static double milliseconds(qint64 nsecs)
+{
+    return nsecs / 1e6;
+}
+
+PlanHud::PlanHud()
+    : m_next(0)
+{
+    m_clock.start();
+    m_samples.reserve(HistoryFrames);
+}
+
+void PlanHud::addFrame(qint64 nsecs, const PaintStats::Frame &stats)
+{
+    Sample sample;
+    sample.time = m_clock.nsecsElapsed();
+    sample.nsecs = nsecs;
+    sample.stats = stats;
+
+    if (m_samples.size() < HistoryFrames)
+        m_samples.append(sample);
+    else
+        m_samples[m_next] = sample;
+    m_next = (m_next + 1) % HistoryFrames;
+}
+
+void PlanHud::clear()
+{
+    m_samples.clear();
+    m_next = 0;
+}
+
+static QFont hudFont()
+{
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    font.setPointSize(9);
+    return font;
+}
+
+QRect PlanHud::rect(const QSize &viewport) const
+{
+    const QFontMetrics metrics(hudFont());
+    const int width = qMin(viewport.width() - 2 * Margin,
+                           metrics.horizontalAdvance(QLatin1Char('0')) * 44 + 2 * Padding);
+    const int height = metrics.lineSpacing() * TextLines + HistogramHeight + 2 * Padding + 2;
+    return QRect(Margin, Margin, width, height);
+}
+
+void PlanHud::draw(QPainter *painter, const QSize &viewport) const
+{
+    /* Frames of the last second for the numbers, all of them for the histogram */
+    const qint64 now = m_clock.nsecsElapsed();
+    PaintStats::Frame second;
+    qint64 frameNsecs = 0;
+    int frames = 0;
+    int buckets[BucketCount] = {};
+    int tallest = 1;
+
+    for (const Sample &sample : m_samples) {
+        const double ms = milliseconds(sample.nsecs);
+        int bucket = 0;
+        while (bucket < BucketCount - 1 && ms >= BucketLimits[bucket])
+            bucket++;
+        tallest = qMax(tallest, ++buckets[bucket]);
+
+        if (now - sample.time > 1000000000)
+            continue;
+        frames++;
+        frameNsecs += sample.nsecs;
+        for (int i = 0; i < PaintStats::KindCount; i++) {
+            second.nsecs[i] += sample.stats.nsecs[i];
+            second.counts[i] += sample.stats.counts[i];
+        }
+        second.cacheHits += sample.stats.cacheHits;
+        second.cacheMisses += sample.stats.cacheMisses;
+    }
+
+    const int divisor = qMax(frames, 1);
+    const int lookups = second.cacheHits + second.cacheMisses;
+    const QString hitRate = lookups ? QString("%1%").arg(100 * second.cacheHits / lookups) : QString("-");
+
+    const QStringList lines = QStringList()
+        << QString("%1 fps  %2 ms/frame  %3 items")
+               .arg(frames)
+               .arg(milliseconds(frameNsecs / divisor), 0, 'f', 1)
+               .arg((second.counts[PaintStats::RoomPaint] + second.counts[PaintStats::FurniturePaint]) / divisor)
+        << QString("rooms %1 ms  furniture %2 ms")
+               .arg(milliseconds(second.nsecs[PaintStats::RoomPaint] / divisor), 0, 'f', 2)
+               .arg(milliseconds(second.nsecs[PaintStats::FurniturePaint] / divisor), 0, 'f', 2)
+        << QString("decode %1 ms  index %2 ms")
+               .arg(milliseconds(second.nsecs[PaintStats::Decode] / divisor), 0, 'f', 2)
+               .arg(milliseconds(second.nsecs[PaintStats::IndexQuery] / divisor), 0, 'f', 2)
+        << QString("image cache hits %1").arg(hitRate);
+
+    const QRect box = rect(viewport);
+    painter->save();
+    painter->resetTransform();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setFont(hudFont());
+    painter->fillRect(box, QColor(0, 0, 0, 170));
+    painter->setPen(Qt::white);
+
+    const QFontMetrics metrics = painter->fontMetrics();
+    int y = box.top() + Padding + metrics.ascent();
+    for (const QString &line : lines) {
+        painter->drawText(box.left() + Padding, y, line);
+        y += metrics.lineSpacing();
+    }
+
+    /* Histogram: one bar per bucket, labelled with its upper bound */
+    const QRect chart(box.left() + Padding, y - metrics.ascent() + 2,
+                      box.width() - 2 * Padding, HistogramHeight);
+    const int barWidth = chart.width() / BucketCount;
+    for (int i = 0; i < BucketCount; i++) {
+        const int height = (chart.height() - metrics.lineSpacing()) * buckets[i] / tallest;
+        const QRect bar(chart.left() + i * barWidth + 1, chart.bottom() - metrics.lineSpacing() - height,
+                        barWidth - 2, height);
+        /* Green within a 60 Hz frame, yellow within two, red beyond */
+        painter->fillRect(bar, i < 3 ? QColor(80, 200, 80) : i < 4 ? QColor(220, 200, 60) : QColor(220, 70, 60));
+
+        const QString label = i < BucketCount - 1 ? QString("<%1").arg(BucketLimits[i])
+                                                  : QString(">%1").arg(BucketLimits[i - 1]);
+        painter->drawText(QRect(chart.left() + i * barWidth, chart.bottom() - metrics.lineSpacing(),
+                                barWidth, metrics.lineSpacing()), Qt::AlignCenter, label);
+    }
+
+    painter->restore();
+}
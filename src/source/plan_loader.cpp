@@ -0,0 +1,42 @@
+#include <QBuffer>
+
+#include "../headers/plan_loader.hpp"
+#include "../headers/project_file.hpp"
+#include "../headers/project_bundle.hpp"
+#include "../headers/json_interchange.hpp"
+#include "../headers/trace.hpp"
+
+bool PlanLoader::load(const QString &fileName, QVector<PlanRecord> &records,
+                      QString *errorString)
+{
+    TraceSpan span("PlanLoader::load", "io");
+    if (fileName.endsWith(".json", Qt::CaseInsensitive))
+        return JsonInterchange::load(fileName, records, errorString);
+
+    if (!ProjectBundle::isBundle(fileName))
+        return ProjectReader::load(fileName, records, errorString);
+
+    QByteArray project;
+    if (!ProjectBundle::open(fileName, project, errorString))
+        return false;
+
+    QBuffer buffer(&project);
+    buffer.open(QIODevice::ReadOnly);
+    ProjectReader reader(&buffer);
+    if (!reader.readHeader()) {
+        if (errorString)
+            *errorString = reader.errorString();
+        return false;
+    }
+
+    QVector<PlanRecord> chunk;
+    while (reader.readChunk(chunk))
+        records += chunk;
+
+    if (reader.hasError()) {
+        if (errorString)
+            *errorString = reader.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,255 @@
+#include <QThreadStorage>
+
+#include "../headers/plan_model.hpp"
+#include "../headers/plan_geometry.hpp"
+
+static PlanGeometry::Quad quadOf(const PlanItem &item)
+{
+    return PlanGeometry::quad(item.id, item.x, item.y, item.width, item.height, item.angle);
+}
+
+PlanModel::PlanModel()
+{
+    /* Image 0 is "no image", the default grey floor */
+    m_images.append(QString());
+    m_imageIds.insert(QString(), 0);
+}
+
+PlanModel &PlanModel::detached()
+{
+    static QThreadStorage<PlanModel*> models;
+    if (!models.hasLocalData())
+        models.setLocalData(new PlanModel);
+    return *models.localData();
+}
+
+quint64 PlanModel::add(const PlanRecord &record)
+{
+    PlanItem item;
+    item.id = record.id ? record.id : PlanRecord::nextId();
+    item.x = record.x;
+    item.y = record.y;
+    item.width = float(record.width);
+    item.height = float(record.height);
+    item.angle = float(record.angle);
+    item.zValue = float(record.zValue);
+    item.image = intern(record.urlPath);
+    item.kind = record.kind;
+    item.flipped = record.flipped;
+
+    PlanRecord::reserveId(item.id);
+
+    auto slot = m_slots.constFind(item.id);
+    if (slot != m_slots.constEnd()) {
+        m_items[*slot] = item;
+    }
+    else {
+        m_slots.insert(item.id, m_items.size());
+        m_items.append(item);
+    }
+    return item.id;
+}
+
+bool PlanModel::remove(quint64 id)
+{
+    auto slot = m_slots.find(id);
+    if (slot == m_slots.end())
+        return false;
+
+    /* The last item fills the hole, so the array stays contiguous */
+    const int index = *slot;
+    m_slots.erase(slot);
+    if (index != m_items.size() - 1) {
+        m_items[index] = m_items.last();
+        m_slots[m_items[index].id] = index;
+    }
+    m_items.removeLast();
+    return true;
+}
+
+void PlanModel::clear()
+{
+    m_items.clear();
+    m_slots.clear();
+}
+
+void PlanModel::moveTo(quint64 id, PlanModel &other)
+{
+    if (&other == this || !contains(id))
+        return;
+
+    other.add(record(id));
+    remove(id);
+}
+
+bool PlanModel::contains(quint64 id) const
+{
+    return m_slots.contains(id);
+}
+
+int PlanModel::size() const
+{
+    return m_items.size();
+}
+
+int PlanModel::count(PlanRecord::Kind kind) const
+{
+    int n = 0;
+    for (const PlanItem &item : m_items)
+        n += item.kind == kind;
+    return n;
+}
+
+const PlanItem *PlanModel::item(quint64 id) const
+{
+    auto slot = m_slots.constFind(id);
+    return slot == m_slots.constEnd() ? nullptr : &m_items.at(*slot);
+}
+
+PlanItem *PlanModel::find(quint64 id)
+{
+    auto slot = m_slots.constFind(id);
+    return slot == m_slots.constEnd() ? nullptr : &m_items[*slot];
+}
+
+const QVector<PlanItem> &PlanModel::items() const
+{
+    return m_items;
+}
+
+QString PlanModel::image(const PlanItem &item) const
+{
+    return m_images.value(int(item.image));
+}
+
+quint32 PlanModel::intern(const QString &urlPath)
+{
+    auto known = m_imageIds.constFind(urlPath);
+    if (known != m_imageIds.constEnd())
+        return *known;
+
+    const quint32 index = quint32(m_images.size());
+    m_images.append(urlPath);
+    m_imageIds.insert(urlPath, index);
+    return index;
+}
+
+PlanRecord PlanModel::record(quint64 id) const
+{
+    PlanRecord record;
+    const PlanItem *item = this->item(id);
+    if (!item)
+        return record;
+
+    record.id = item->id;
+    record.kind = item->kind;
+    record.urlPath = image(*item);
+    record.x = item->x;
+    record.y = item->y;
+    record.width = item->width;
+    record.height = item->height;
+    record.angle = item->angle;
+    record.zValue = item->zValue;
+    record.flipped = item->flipped;
+    return record;
+}
+
+QVector<PlanRecord> PlanModel::records() const
+{
+    QVector<PlanRecord> records;
+    records.reserve(m_items.size());
+    for (const PlanItem &item : m_items)
+        records.append(record(item.id));
+    return records;
+}
+
+/* Transforms */
+
+void PlanModel::setPosition(quint64 id, qreal x, qreal y)
+{
+    if (PlanItem *item = find(id)) {
+        item->x = x;
+        item->y = y;
+    }
+}
+
+void PlanModel::setAngle(quint64 id, qreal angle)
+{
+    if (PlanItem *item = find(id))
+        item->angle = float(angle);
+}
+
+void PlanModel::setZValue(quint64 id, qreal zValue)
+{
+    if (PlanItem *item = find(id))
+        item->zValue = float(zValue);
+}
+
+void PlanModel::setFlipped(quint64 id, bool flipped)
+{
+    if (PlanItem *item = find(id))
+        item->flipped = flipped;
+}
+
+void PlanModel::setImage(quint64 id, const QString &urlPath)
+{
+    if (PlanItem *item = find(id))
+        item->image = intern(urlPath);
+}
+
+/* Geometry */
+
+QRectF PlanModel::boundingRect(quint64 id) const
+{
+    const PlanItem *item = this->item(id);
+    return item ? quadOf(*item).bounds : QRectF();
+}
+
+double PlanModel::area(quint64 id) const
+{
+    const PlanItem *item = this->item(id);
+    if (!item)
+        return 0;
+    return double(item->width) * item->height
+           / (PlanGeometry::PixelsPerMeter * PlanGeometry::PixelsPerMeter);
+}
+
+double PlanModel::roomArea() const
+{
+    double total = 0;
+    for (const PlanItem &item : m_items) {
+        if (item.kind == PlanRecord::RoomKind)
+            total += double(item.width) * item.height;
+    }
+    return total / (PlanGeometry::PixelsPerMeter * PlanGeometry::PixelsPerMeter);
+}
+
+QVector<quint64> PlanModel::itemsIn(const QRectF &rect) const
+{
+    QVector<quint64> ids;
+    for (const PlanItem &item : m_items) {
+        if (quadOf(item).bounds.intersects(rect))
+            ids.append(item.id);
+    }
+    return ids;
+}
+
+QVector<quint64> PlanModel::collisions(quint64 id) const
+{
+    QVector<quint64> ids;
+    const PlanItem *target = item(id);
+    if (!target)
+        return ids;
+
+    const PlanGeometry::Quad outline = quadOf(*target);
+    for (const PlanItem &other : m_items) {
+        if (other.id == id || other.kind != target->kind)
+            continue;
+
+        const PlanGeometry::Quad otherOutline = quadOf(other);
+        if (outline.bounds.intersects(otherOutline.bounds)
+                && PlanGeometry::overlaps(outline, otherOutline))
+            ids.append(other.id);
+    }
+    return ids;
+}
@@ -0,0 +1,94 @@
+#include "../headers/plan_op.hpp"
+
+void PlanOp::applyTo(QMap<quint64, PlanRecord> &records) const
+{
+    if (type == Add) {
+        records.insert(record.id, record);
+        return;
+    }
+    if (type == Delete) {
+        records.remove(record.id);
+        return;
+    }
+
+    auto it = records.find(record.id);
+    if (it == records.end())
+        return;
+
+    switch (type) {
+        case Move:
+            it->x = record.x;
+            it->y = record.y;
+            break;
+        case Rotate:
+            it->angle = record.angle;
+            break;
+        case Flip:
+            it->flipped = record.flipped;
+            break;
+        case Floor:
+            it->urlPath = record.urlPath;
+            break;
+        default:
+            break;
+    }
+}
+
+QDataStream &operator<<(QDataStream &out, const PlanOp &op)
+{
+    out << quint8(op.type);
+
+    switch (op.type) {
+        case PlanOp::Add:
+            out << op.record;
+            break;
+        case PlanOp::Move:
+            out << op.record.id << op.record.x << op.record.y;
+            break;
+        case PlanOp::Rotate:
+            out << op.record.id << op.record.angle;
+            break;
+        case PlanOp::Flip:
+            out << op.record.id << op.record.flipped;
+            break;
+        case PlanOp::Delete:
+            out << op.record.id;
+            break;
+        case PlanOp::Floor:
+            out << op.record.id << op.record.urlPath;
+            break;
+    }
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, PlanOp &op)
+{
+    quint8 type;
+    in >> type;
+    op.type = PlanOp::Type(type);
+
+    switch (op.type) {
+        case PlanOp::Add:
+            in >> op.record;
+            break;
+        case PlanOp::Move:
+            in >> op.record.id >> op.record.x >> op.record.y;
+            break;
+        case PlanOp::Rotate:
+            in >> op.record.id >> op.record.angle;
+            break;
+        case PlanOp::Flip:
+            in >> op.record.id >> op.record.flipped;
+            break;
+        case PlanOp::Delete:
+            in >> op.record.id;
+            break;
+        case PlanOp::Floor:
+            in >> op.record.id >> op.record.urlPath;
+            break;
+        default:
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
+    }
+    return in;
+}
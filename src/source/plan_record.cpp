@@ -0,0 +1,67 @@
+#include <atomic>
+#include <QtMath>
+
+#include "../headers/plan_record.hpp"
+
+/* Ids start at 1, 0 means "not assigned" */
+static std::atomic<quint64> idCounter(1);
+
+quint64 PlanRecord::nextId()
+{
+    return idCounter++;
+}
+
+void PlanRecord::reserveId(quint64 id)
+{
+    /* Make sure ids read from a file are never handed out again */
+    quint64 current = idCounter.load();
+    while (current <= id && !idCounter.compare_exchange_weak(current, id + 1))
+        ;
+}
+
+QRectF PlanRecord::sceneBoundingRect() const
+{
+    if (qFuzzyIsNull(angle))
+        return QRectF(x, y, width, height);
+
+    /* Items rotate around their center (see Room::rotate, Furniture::rotate) */
+    const qreal rad = qDegreesToRadians(angle);
+    const qreal c = qAbs(qCos(rad));
+    const qreal s = qAbs(qSin(rad));
+    const qreal w = width * c + height * s;
+    const qreal h = width * s + height * c;
+    const QPointF center(x + width / 2, y + height / 2);
+
+    return QRectF(center.x() - w / 2, center.y() - h / 2, w, h);
+}
+
+bool operator==(const PlanRecord &a, const PlanRecord &b)
+{
+    return a.id == b.id && a.kind == b.kind && a.x == b.x && a.y == b.y
+            && a.width == b.width && a.height == b.height && a.angle == b.angle
+            && a.zValue == b.zValue && a.flipped == b.flipped && a.urlPath == b.urlPath;
+}
+
+bool operator!=(const PlanRecord &a, const PlanRecord &b)
+{
+    return !(a == b);
+}
+
+QDataStream &operator<<(QDataStream &out, const PlanRecord &record)
+{
+    out << record.id << quint8(record.kind) << record.urlPath
+        << record.x << record.y << record.width << record.height
+        << record.angle << record.zValue << record.flipped;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, PlanRecord &record)
+{
+    quint8 kind;
+    in >> record.id >> kind >> record.urlPath
+       >> record.x >> record.y >> record.width >> record.height
+       >> record.angle >> record.zValue >> record.flipped;
+    record.kind = kind == PlanRecord::RoomKind ? PlanRecord::RoomKind
+                                               : PlanRecord::FurnitureKind;
+    return in;
+}
@@ -0,0 +1,350 @@
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QTransform>
+
+#include "../headers/plan_scene.hpp"
+#include "../headers/furniture.hpp"
+#include "../headers/room.hpp"
+#include "../headers/trace.hpp"
+
+PlanScene::PlanScene(QObject *parent)
+    : QGraphicsScene(parent), m_nudge(new NudgeController(this)),
+      m_renderQuality(FullQuality), m_roomsLocked(false), m_transactionDepth(0)
+{
+}
+
+PlanScene::~PlanScene()
+{
+    /* Items are views of m_model, they have to go while it still exists.
+     * Nobody is interested in these deletions. */
+    blockSignals(true);
+    clear();
+}
+
+PlanModel &PlanScene::model()
+{
+    return m_model;
+}
+
+const PlanModel &PlanScene::model() const
+{
+    return m_model;
+}
+
+void PlanScene::itemChanged(QGraphicsItem *item, PlanOp::Type type, const PlanRecord &record)
+{
+    if (type == PlanOp::Add) {
+        m_views.insert(record.id, item);
+        if (item->isSelected())
+            m_selection.setSelected(item, true);
+    }
+    else if (type == PlanOp::Delete) {
+        if (m_views.value(record.id) == item)
+            m_views.remove(record.id);
+        /* Removed and deleted items never report being deselected */
+        m_selection.remove(item);
+    }
+
+    PlanOp op;
+    op.type = type;
+    op.record = record;
+
+    if (m_transactionDepth == 0) {
+        emit planChanged(op);
+        return;
+    }
+
+    /* Adding or deleting ends what came before, later edits must follow it */
+    if (type == PlanOp::Add || type == PlanOp::Delete) {
+        for (int t = PlanOp::Move; t <= PlanOp::Floor; t++)
+            m_transactionIndex.remove(qMakePair(record.id, t));
+        m_transactionOps.append(op);
+        return;
+    }
+
+    const QPair<quint64, int> key(record.id, type);
+    auto slot = m_transactionIndex.constFind(key);
+    if (slot != m_transactionIndex.constEnd()) {
+        m_transactionOps[*slot] = op;
+    }
+    else {
+        m_transactionIndex.insert(key, m_transactionOps.size());
+        m_transactionOps.append(op);
+    }
+}
+
+void PlanScene::beginTransaction()
+{
+    m_transactionDepth++;
+}
+
+void PlanScene::endTransaction()
+{
+    if (m_transactionDepth == 0 || --m_transactionDepth > 0)
+        return;
+
+    const QVector<PlanOp> ops = m_transactionOps;
+    m_transactionOps.clear();
+    m_transactionIndex.clear();
+
+    for (const PlanOp &op : ops)
+        emit planChanged(op);
+}
+
+/* Updating the BSP index item by item costs a removal and an insertion
+ * each, with no index at all the scene is only reindexed once. That one
+ * rebuild goes over every item in the scene, so it only pays off when
+ * the batch is a good part of it. */
+bool PlanScene::suspendIndex(int itemCount)
+{
+    if (itemCount < IndexRebuildThreshold || itemIndexMethod() != BspTreeIndex
+            || qint64(itemCount) * IndexRebuildFraction < m_model.size())
+        return false;
+
+    setItemIndexMethod(NoIndex);
+    return true;
+}
+
+void PlanScene::resumeIndex(bool suspended)
+{
+    if (suspended)
+        setItemIndexMethod(BspTreeIndex);
+}
+
+void PlanScene::moveItems(const QVector<QGraphicsItem*> &items, qreal dx, qreal dy)
+{
+    if (items.isEmpty())
+        return;
+
+    const bool suspended = suspendIndex(items.size());
+    beginTransaction();
+    for (QGraphicsItem *item : items)
+        item->moveBy(dx, dy);
+    endTransaction();
+    resumeIndex(suspended);
+}
+
+/* Furniture and rooms turn around their own center */
+bool PlanScene::rotate(QGraphicsItem *item, qreal angle)
+{
+    if (Room *room = qgraphicsitem_cast<Room*>(item))
+        room->rotate(angle);
+    else if (Furniture *furniture = qgraphicsitem_cast<Furniture*>(item))
+        furniture->rotate(angle);
+    else
+        return false;
+    return true;
+}
+
+void PlanScene::rotateItems(const QVector<QGraphicsItem*> &items, qreal angle)
+{
+    if (items.isEmpty())
+        return;
+
+    const bool suspended = suspendIndex(items.size());
+    beginTransaction();
+    for (QGraphicsItem *item : items)
+        rotate(item, angle);
+    endTransaction();
+    resumeIndex(suspended);
+}
+
+void PlanScene::rotateGroup(const QVector<QGraphicsItem*> &items, qreal angle)
+{
+    if (items.isEmpty())
+        return;
+
+    QRectF bounds;
+    for (QGraphicsItem *item : items)
+        bounds |= item->sceneBoundingRect();
+    const QPointF pivot = bounds.center();
+    const QTransform turn = QTransform().rotate(angle);
+
+    const bool suspended = suspendIndex(items.size());
+    beginTransaction();
+    for (QGraphicsItem *item : items) {
+        /* Each item turns around its own center, which then
+         * travels around the pivot */
+        if (!rotate(item, angle))
+            continue;
+
+        const QPointF center = item->mapToScene(item->transformOriginPoint());
+        const QPointF target = pivot + turn.map(center - pivot);
+        if (target != center)
+            item->moveBy(target.x() - center.x(), target.y() - center.y());
+    }
+    endTransaction();
+    resumeIndex(suspended);
+}
+
+void PlanScene::flipItems(const QVector<QGraphicsItem*> &items)
+{
+    beginTransaction();
+    for (QGraphicsItem *item : items) {
+        if (Furniture *furniture = qgraphicsitem_cast<Furniture*>(item)) {
+            furniture->swapFlipped();
+            furniture->update();    // Immediately call paint() which redraws the furniture
+        }
+    }
+    endTransaction();
+}
+
+void PlanScene::itemSelectionChanged(QGraphicsItem *item, bool selected)
+{
+    TraceSpan span("PlanScene::itemSelectionChanged", "selection");
+    m_selection.setSelected(item, selected);
+}
+
+const PlanSelection &PlanScene::selection() const
+{
+    return m_selection;
+}
+
+NudgeController &PlanScene::nudge()
+{
+    return *m_nudge;
+}
+
+PlanScene::RenderQuality PlanScene::renderQuality() const
+{
+    return m_renderQuality;
+}
+
+void PlanScene::setRenderQuality(RenderQuality quality)
+{
+    m_renderQuality = quality;
+}
+
+void PlanScene::setRoomsLocked(bool locked)
+{
+    if (locked) {
+        /* Deselecting shrinks the selection, so work on a copy */
+        const QVector<Room*> selected = m_selection.rooms();
+        for (Room *room : selected)
+            room->setSelected(false);
+    }
+    m_roomsLocked = locked;
+}
+
+bool PlanScene::roomsLocked() const
+{
+    return m_roomsLocked;
+}
+
+/* Called at the end of every paint of every view */
+void PlanScene::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsScene::drawForeground(painter, rect);
+    m_nudge->framePainted();
+}
+
+QGraphicsItem *PlanScene::item(quint64 id) const
+{
+    return m_views.value(id, nullptr);
+}
+
+PlanScene *PlanScene::of(const QGraphicsItem *item)
+{
+    return qobject_cast<PlanScene*>(item->scene());
+}
+
+void PlanScene::markDirty(quint64 id, QGraphicsItem *item)
+{
+    m_dirtyItems.insert(id, item);
+    m_removedIds.remove(id);
+}
+
+void PlanScene::markRemoved(quint64 id)
+{
+    m_dirtyItems.remove(id);
+    m_removedIds.insert(id);
+}
+
+bool PlanScene::hasChanges() const
+{
+    return !m_dirtyItems.isEmpty() || !m_removedIds.isEmpty();
+}
+
+void PlanScene::takeChanges(QVector<PlanRecord> &changed, QVector<quint64> &removed)
+{
+    changed.clear();
+    removed.clear();
+    changed.reserve(m_dirtyItems.size());
+
+    for (QGraphicsItem *item : m_dirtyItems) {
+        if (Room *room = qgraphicsitem_cast<Room*>(item)) {
+            changed.append(room->record());
+            room->clearDirty();
+        }
+        else if (Furniture *furniture = qgraphicsitem_cast<Furniture*>(item)) {
+            changed.append(furniture->record());
+            furniture->clearDirty();
+        }
+    }
+
+    for (quint64 id : m_removedIds)
+        removed.append(id);
+
+    m_dirtyItems.clear();
+    m_removedIds.clear();
+}
+
+QGraphicsItem *PlanScene::addRecord(const PlanRecord &record)
+{
+    TraceSpan span("PlanScene::addRecord", "scene");
+    QGraphicsItem *item;
+    if (record.kind == PlanRecord::RoomKind)
+        item = new Room(record);
+    else
+        item = new Furniture(record);
+
+    addItem(item);
+    return item;
+}
+
+bool PlanScene::updateItem(const PlanRecord &record)
+{
+    QGraphicsItem *view = item(record.id);
+    if (!view)
+        return false;
+
+    if (view->pos() != QPointF(record.x, record.y))
+        view->setPos(record.x, record.y);
+    if (view->zValue() != record.zValue)
+        view->setZValue(record.zValue);
+
+    if (Room *room = qgraphicsitem_cast<Room*>(view)) {
+        if (room->rotation() != record.angle)
+            room->rotate(record.angle - room->rotation());
+        if (room->floorPath() != record.urlPath)
+            room->setFloorPath(record.urlPath);
+    }
+    else if (Furniture *furniture = qgraphicsitem_cast<Furniture*>(view)) {
+        if (furniture->rotation() != record.angle)
+            furniture->rotate(record.angle - furniture->rotation());
+        if (furniture->isFlipped() != record.flipped) {
+            furniture->swapFlipped();
+            furniture->update();
+        }
+    }
+    return true;
+}
+
+QImage PlanScene::toImage(qreal scale, int margin)
+{
+    TraceSpan span("PlanScene::toImage", "export");
+    const QRectF source = itemsBoundingRect();
+    const QSize size = (source.size() * scale).toSize() + QSize(2 * margin, 2 * margin);
+
+    QImage image(size.expandedTo(QSize(1, 1)), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    render(&painter, QRectF(margin, margin, source.width() * scale, source.height() * scale),
+           source, Qt::IgnoreAspectRatio);
+    painter.end();
+
+    return image;
+}
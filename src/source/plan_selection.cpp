@@ -0,0 +1,70 @@
+#include "../headers/plan_selection.hpp"
+#include "../headers/furniture.hpp"
+#include "../headers/room.hpp"
+
+void PlanSelection::setSelected(QGraphicsItem *item, bool selected)
+{
+    if (Room *room = qgraphicsitem_cast<Room*>(item)) {
+        if (selected)
+            m_rooms.insert(room);
+        else
+            m_rooms.remove(room);
+    }
+    else if (Furniture *furniture = qgraphicsitem_cast<Furniture*>(item)) {
+        if (selected)
+            m_furniture.insert(furniture);
+        else
+            m_furniture.remove(furniture);
+    }
+}
+
+void PlanSelection::remove(QGraphicsItem *item)
+{
+    setSelected(item, false);
+}
+
+void PlanSelection::clear()
+{
+    m_rooms.clear();
+    m_furniture.clear();
+}
+
+bool PlanSelection::isEmpty() const
+{
+    return m_rooms.isEmpty() && m_furniture.isEmpty();
+}
+
+int PlanSelection::size() const
+{
+    return m_rooms.size() + m_furniture.size();
+}
+
+bool PlanSelection::contains(const QGraphicsItem *item) const
+{
+    if (const Room *room = qgraphicsitem_cast<const Room*>(item))
+        return m_rooms.contains(const_cast<Room*>(room));
+    if (const Furniture *furniture = qgraphicsitem_cast<const Furniture*>(item))
+        return m_furniture.contains(const_cast<Furniture*>(furniture));
+    return false;
+}
+
+const QVector<Room*> &PlanSelection::rooms() const
+{
+    return m_rooms.items();
+}
+
+const QVector<Furniture*> &PlanSelection::furniture() const
+{
+    return m_furniture.items();
+}
+
+QVector<QGraphicsItem*> PlanSelection::items() const
+{
+    QVector<QGraphicsItem*> all;
+    all.reserve(size());
+    for (Room *room : m_rooms.items())
+        all.append(room);
+    for (Furniture *furniture : m_furniture.items())
+        all.append(furniture);
+    return all;
+}
@@ -0,0 +1,259 @@
+#include <QtAlgorithms>
+
+#include "../headers/plan_snapshot.hpp"
+
+/* One level of the trie. Each of the 32 slots holds nothing, a record or
+ * a deeper node, both kinds packed in slot order behind a bitmap. */
+struct SnapshotNode : public QSharedData
+{
+    quint32 leafMap = 0;
+    quint32 childMap = 0;
+    QVector<PlanRecord> leaves;
+    QVector<QSharedDataPointer<SnapshotNode>> children;
+};
+
+/* 5 id bits per level, lowest first, so 13 levels tell any two ids apart */
+static const int SlotBits = 5;
+
+static quint32 slotBit(quint64 id, int depth)
+{
+    return 1u << ((id >> (depth * SlotBits)) & 31);
+}
+
+/* Position of a slot among the occupied ones */
+static int indexOf(quint32 map, quint32 bit)
+{
+    return qPopulationCount(map & (bit - 1));
+}
+
+static void collect(const SnapshotNode *node, QVector<PlanRecord> &out)
+{
+    out += node->leaves;
+    for (const QSharedDataPointer<SnapshotNode> &child : node->children)
+        collect(child.constData(), out);
+}
+
+/* Returns true when the id was not there before */
+static bool insertInto(QSharedDataPointer<SnapshotNode> &node, const PlanRecord &record, int depth)
+{
+    const quint32 bit = slotBit(record.id, depth);
+    const SnapshotNode *current = node.constData();
+
+    if (current->childMap & bit) {
+        const int i = indexOf(current->childMap, bit);
+        return insertInto(node->children[i], record, depth + 1);
+    }
+
+    if (current->leafMap & bit) {
+        const int i = indexOf(current->leafMap, bit);
+        if (current->leaves.at(i).id == record.id) {
+            node->leaves[i] = record;
+            return false;
+        }
+
+        /* Two ids share this slot, both move one level down */
+        const PlanRecord other = current->leaves.at(i);
+        QSharedDataPointer<SnapshotNode> child(new SnapshotNode);
+        insertInto(child, other, depth + 1);
+        insertInto(child, record, depth + 1);
+
+        SnapshotNode *writable = node.data();
+        writable->leaves.remove(i);
+        writable->leafMap &= ~bit;
+        writable->children.insert(indexOf(writable->childMap, bit), child);
+        writable->childMap |= bit;
+        return true;
+    }
+
+    SnapshotNode *writable = node.data();
+    writable->leaves.insert(indexOf(writable->leafMap, bit), record);
+    writable->leafMap |= bit;
+    return true;
+}
+
+/* Only called for ids that are present, so nothing detaches in vain */
+static void removeFrom(QSharedDataPointer<SnapshotNode> &node, quint64 id, int depth)
+{
+    const quint32 bit = slotBit(id, depth);
+    const SnapshotNode *current = node.constData();
+
+    if (current->leafMap & bit) {
+        SnapshotNode *writable = node.data();
+        writable->leaves.remove(indexOf(writable->leafMap, bit));
+        writable->leafMap &= ~bit;
+        return;
+    }
+
+    const int i = indexOf(current->childMap, bit);
+    SnapshotNode *writable = node.data();
+    QSharedDataPointer<SnapshotNode> &child = writable->children[i];
+    removeFrom(child, id, depth + 1);
+
+    /* A child left with a single record gives it back to this level */
+    const SnapshotNode *rest = child.constData();
+    if (rest->childMap == 0 && rest->leaves.size() <= 1) {
+        const QVector<PlanRecord> leaves = rest->leaves;
+        writable->children.remove(i);
+        writable->childMap &= ~bit;
+        if (!leaves.isEmpty()) {
+            writable->leaves.insert(indexOf(writable->leafMap, bit), leaves.first());
+            writable->leafMap |= bit;
+        }
+    }
+}
+
+/* Records that differ between one slot of two nodes, at most one side
+ * holds a subtree here, the other one a single record or nothing */
+static void diffSlot(const QVector<PlanRecord> &from, const QVector<PlanRecord> &to, PlanDiff &diff)
+{
+    for (const PlanRecord &record : from) {
+        bool kept = false;
+        for (const PlanRecord &other : to)
+            kept = kept || other.id == record.id;
+        if (!kept)
+            diff.removed.append(record.id);
+    }
+
+    for (const PlanRecord &record : to) {
+        const PlanRecord *previous = nullptr;
+        for (const PlanRecord &other : from)
+            if (other.id == record.id)
+                previous = &other;
+
+        if (!previous)
+            diff.added.append(record);
+        else if (*previous != record)
+            diff.changed.append(record);
+    }
+}
+
+static void diffNodes(const SnapshotNode *from, const SnapshotNode *to, PlanDiff &diff)
+{
+    /* The whole point: shared subtrees are never looked into */
+    if (from == to)
+        return;
+
+    const quint32 used = from->leafMap | from->childMap | to->leafMap | to->childMap;
+    for (int slot = 0; slot < 32; slot++) {
+        const quint32 bit = 1u << slot;
+        if (!(used & bit))
+            continue;
+
+        if ((from->childMap & bit) && (to->childMap & bit)) {
+            diffNodes(from->children.at(indexOf(from->childMap, bit)).constData(),
+                      to->children.at(indexOf(to->childMap, bit)).constData(), diff);
+            continue;
+        }
+
+        QVector<PlanRecord> before, after;
+        if (from->leafMap & bit)
+            before.append(from->leaves.at(indexOf(from->leafMap, bit)));
+        else if (from->childMap & bit)
+            collect(from->children.at(indexOf(from->childMap, bit)).constData(), before);
+
+        if (to->leafMap & bit)
+            after.append(to->leaves.at(indexOf(to->leafMap, bit)));
+        else if (to->childMap & bit)
+            collect(to->children.at(indexOf(to->childMap, bit)).constData(), after);
+
+        diffSlot(before, after, diff);
+    }
+}
+
+bool PlanDiff::isEmpty() const
+{
+    return removed.isEmpty() && added.isEmpty() && changed.isEmpty();
+}
+
+PlanSnapshot::PlanSnapshot()
+    : m_root(new SnapshotNode), m_size(0)
+{
+}
+
+PlanSnapshot::PlanSnapshot(const QVector<PlanRecord> &records)
+    : PlanSnapshot()
+{
+    for (const PlanRecord &record : records)
+        insert(record);
+}
+
+PlanSnapshot::PlanSnapshot(const PlanSnapshot &other) = default;
+PlanSnapshot &PlanSnapshot::operator=(const PlanSnapshot &other) = default;
+PlanSnapshot::~PlanSnapshot() = default;
+
+int PlanSnapshot::size() const
+{
+    return m_size;
+}
+
+bool PlanSnapshot::isEmpty() const
+{
+    return m_size == 0;
+}
+
+bool PlanSnapshot::contains(quint64 id) const
+{
+    return find(id) != nullptr;
+}
+
+const PlanRecord *PlanSnapshot::find(quint64 id) const
+{
+    const SnapshotNode *node = m_root.constData();
+    for (int depth = 0; node; depth++) {
+        const quint32 bit = slotBit(id, depth);
+        if (node->leafMap & bit) {
+            const PlanRecord &record = node->leaves.at(indexOf(node->leafMap, bit));
+            return record.id == id ? &record : nullptr;
+        }
+        if (!(node->childMap & bit))
+            return nullptr;
+        node = node->children.at(indexOf(node->childMap, bit)).constData();
+    }
+    return nullptr;
+}
+
+QVector<PlanRecord> PlanSnapshot::records() const
+{
+    QVector<PlanRecord> out;
+    out.reserve(m_size);
+    collect(m_root.constData(), out);
+    return out;
+}
+
+void PlanSnapshot::insert(const PlanRecord &record)
+{
+    /* Storing what is already there would still copy the path */
+    const PlanRecord *existing = find(record.id);
+    if (existing && *existing == record)
+        return;
+
+    if (insertInto(m_root, record, 0))
+        m_size++;
+}
+
+void PlanSnapshot::remove(quint64 id)
+{
+    if (!contains(id))
+        return;
+
+    removeFrom(m_root, id, 0);
+    m_size--;
+}
+
+void PlanSnapshot::clear()
+{
+    m_root = QSharedDataPointer<SnapshotNode>(new SnapshotNode);
+    m_size = 0;
+}
+
+bool PlanSnapshot::isSharedWith(const PlanSnapshot &other) const
+{
+    return m_root.constData() == other.m_root.constData();
+}
+
+PlanDiff PlanSnapshot::diff(const PlanSnapshot &from, const PlanSnapshot &to)
+{
+    PlanDiff result;
+    diffNodes(from.m_root.constData(), to.m_root.constData(), result);
+    return result;
+}
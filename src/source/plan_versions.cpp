@@ -0,0 +1,104 @@
+#include "../headers/plan_versions.hpp"
+
+PlanVersions::PlanVersions(PlanScene *scene, QObject *parent)
+    : QObject(parent), m_scene(scene), m_current(-1), m_applying(false)
+{
+    reset();
+    connect(m_scene, &PlanScene::planChanged, this, &PlanVersions::record);
+}
+
+void PlanVersions::reset()
+{
+    m_state = PlanSnapshot(m_scene->model().records());
+}
+
+void PlanVersions::clear()
+{
+    m_versions.clear();
+    m_current = -1;
+    reset();
+    emit versionsChanged();
+}
+
+int PlanVersions::save(const QString &name)
+{
+    Version version;
+    version.name = name;
+    version.snapshot = m_state;
+    version.created = QDateTime::currentDateTime();
+    m_versions.append(version);
+
+    m_current = m_versions.size() - 1;
+    emit versionsChanged();
+    return m_current;
+}
+
+bool PlanVersions::switchTo(int index)
+{
+    if (index < 0 || index >= m_versions.size())
+        return false;
+
+    const PlanSnapshot &target = m_versions.at(index).snapshot;
+    const PlanDiff diff = PlanSnapshot::diff(m_state, target);
+
+    m_applying = true;
+    for (quint64 id : diff.removed)
+        delete m_scene->item(id);
+    for (const PlanRecord &record : diff.changed)
+        m_scene->updateItem(record);
+
+    bool exact = true;
+    for (const PlanRecord &record : diff.added) {
+        QGraphicsItem *item = m_scene->addRecord(record);
+        /* The id may have been taken meanwhile, the item then got a new one */
+        exact = exact && m_scene->item(record.id) == item;
+        emit itemRestored(item);
+    }
+    m_applying = false;
+
+    /* Sharing the version's nodes keeps the next switch cheap */
+    m_state = exact ? target : PlanSnapshot(m_scene->model().records());
+
+    m_current = index;
+    emit versionsChanged();
+    return true;
+}
+
+void PlanVersions::remove(int index)
+{
+    if (index < 0 || index >= m_versions.size())
+        return;
+
+    m_versions.remove(index);
+    if (m_current == index)
+        m_current = -1;
+    else if (m_current > index)
+        m_current--;
+    emit versionsChanged();
+}
+
+int PlanVersions::count() const
+{
+    return m_versions.size();
+}
+
+const PlanVersions::Version &PlanVersions::version(int index) const
+{
+    return m_versions.at(index);
+}
+
+int PlanVersions::current() const
+{
+    return m_current;
+}
+
+void PlanVersions::record(const PlanOp &op)
+{
+    if (m_applying)
+        return;
+
+    if (op.type == PlanOp::Delete)
+        m_state.remove(op.record.id);
+    else
+        m_state.insert(op.record);
+}
@@ -0,0 +1,374 @@
+#include <QGestureEvent>
+#include <QMouseEvent>
+#include <QNativeGestureEvent>
+#include <QPainter>
+#include <QPinchGesture>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <QtMath>
+
+#include "../headers/plan_view.hpp"
+#include "../headers/plan_scene.hpp"
+#include "../headers/plan_hud.hpp"
+#include "../headers/trace.hpp"
+
+static const qreal MinZoom = 0.1;
+static const qreal MaxZoom = 20;
+
+/* Zoom caches are kept for this many levels, and never grow larger */
+static const int MaxZoomCaches = 3;
+static const qreal MaxCachePixels = 2048 * 1024;
+
+/* The overlay redraws itself this often, even when nothing else changes */
+static const int HudInterval = 250;
+
+/* Share of the remaining zoom covered per animation frame */
+static const qreal ZoomEasing = 0.35;
+
+/* Zoom levels are powers of sqrt(2) */
+static int zoomLevel(qreal zoom)
+{
+    return qRound(2 * std::log2(zoom));
+}
+
+static qreal levelZoom(int level)
+{
+    return qPow(2, level / 2.0);
+}
+
+PlanView::PlanView(QWidget *parent)
+    : QGraphicsView(parent), m_adaptive(true), m_interacting(false), m_pressed(false),
+      m_targetZoom(1), m_zooming(false), m_hudRefresh(false)
+{
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(SettleDelay);
+    connect(&m_settleTimer, &QTimer::timeout, this, &PlanView::settle);
+
+    m_zoomTimer.setTimerType(Qt::PreciseTimer);
+    m_zoomTimer.setInterval(16);
+    connect(&m_zoomTimer, &QTimer::timeout, this, &PlanView::zoomStep);
+
+    viewport()->grabGesture(Qt::PinchGesture);
+
+    m_hudTimer.setInterval(HudInterval);
+    connect(&m_hudTimer, &QTimer::timeout, this, &PlanView::refreshHud);
+}
+
+PlanView::~PlanView()
+{
+    setHudVisible(false);
+}
+
+void PlanView::setAdaptiveQuality(bool adaptive)
+{
+    if (!adaptive && m_interacting)
+        endInteraction();
+    m_adaptive = adaptive;
+}
+
+bool PlanView::adaptiveQuality() const
+{
+    return m_adaptive;
+}
+
+bool PlanView::isInteracting() const
+{
+    return m_interacting;
+}
+
+void PlanView::zoomBy(qreal factor)
+{
+    zoomAt(factor, viewport()->rect().center());
+}
+
+void PlanView::zoomAt(qreal factor, const QPoint &viewportPos)
+{
+    /* Steps arriving mid-animation add up */
+    if (!m_zooming)
+        m_targetZoom = zoom();
+    m_targetZoom = qBound(MinZoom, m_targetZoom * factor, MaxZoom);
+
+    m_anchorView = viewportPos;
+    m_anchorScene = mapToScene(viewportPos);
+    m_zooming = true;
+    interact();
+
+    if (!m_zoomTimer.isActive())
+        m_zoomTimer.start();
+}
+
+qreal PlanView::zoom() const
+{
+    return qSqrt(qAbs(transform().determinant()));
+}
+
+void PlanView::zoomStep()
+{
+    const qreal ratio = m_targetZoom / zoom();
+    const bool last = qAbs(ratio - 1) < 0.002;
+    const qreal step = last ? ratio : qPow(ratio, ZoomEasing);
+
+    scale(step, step);
+
+    /* Put the scene point that was under the cursor back under it */
+    const QPoint drift = mapFromScene(m_anchorScene) - m_anchorView;
+    horizontalScrollBar()->setValue(horizontalScrollBar()->value() + drift.x());
+    verticalScrollBar()->setValue(verticalScrollBar()->value() + drift.y());
+
+    if (last) {
+        m_zoomTimer.stop();
+        m_zooming = false;
+        /* Back to drawing the scene itself */
+        viewport()->update();
+    }
+    interact();
+}
+
+void PlanView::wheelEvent(QWheelEvent *event)
+{
+    const int delta = event->angleDelta().y();
+    if (delta == 0) {
+        QGraphicsView::wheelEvent(event);
+        return;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const QPoint at = event->position().toPoint();
+#else
+    const QPoint at = event->pos();
+#endif
+    /* One notch, 120 units, zooms by about 20% */
+    zoomAt(qPow(1.0015, delta), at);
+    event->accept();
+}
+
+bool PlanView::viewportEvent(QEvent *event)
+{
+    if (event->type() == QEvent::Gesture) {
+        QGestureEvent *gestureEvent = static_cast<QGestureEvent*>(event);
+        if (QPinchGesture *pinch = static_cast<QPinchGesture*>(gestureEvent->gesture(Qt::PinchGesture))) {
+            if (pinch->changeFlags() & QPinchGesture::ScaleFactorChanged)
+                zoomAt(pinch->scaleFactor(), viewport()->mapFromGlobal(pinch->centerPoint().toPoint()));
+            gestureEvent->accept(pinch);
+            return true;
+        }
+    }
+    else if (event->type() == QEvent::NativeGesture) {
+        /* Trackpad pinch on macOS */
+        QNativeGestureEvent *gesture = static_cast<QNativeGestureEvent*>(event);
+        if (gesture->gestureType() == Qt::ZoomNativeGesture) {
+            zoomAt(1 + gesture->value(), gesture->pos());
+            return true;
+        }
+    }
+    return QGraphicsView::viewportEvent(event);
+}
+
+void PlanView::setHudVisible(bool visible)
+{
+    if (visible == isHudVisible())
+        return;
+
+    PaintStats::setEnabled(visible);
+    if (visible) {
+        m_hud.reset(new PlanHud);
+        PaintStats::takeFrame();    // Drop what was counted for other views
+        m_hudTimer.start();
+    }
+    else {
+        m_hudTimer.stop();
+        m_hud.reset();
+    }
+    viewport()->update();
+}
+
+bool PlanView::isHudVisible() const
+{
+    return !m_hud.isNull();
+}
+
+void PlanView::refreshHud()
+{
+    m_hudRefresh = true;
+    viewport()->update(m_hud->rect(viewport()->size()));
+}
+
+/* Mid-zoom frames come from the cache, one pixmap instead of every item */
+void PlanView::paintEvent(QPaintEvent *event)
+{
+    TraceSpan span("PlanView::paintEvent", "paint");
+    const qint64 start = PaintStats::now();
+
+    const ZoomCache *cache = m_zooming && m_adaptive ? zoomCache() : nullptr;
+    if (cache) {
+        QPainter painter(viewport());
+        painter.fillRect(event->rect(), backgroundBrush());
+        painter.setTransform(viewportTransform());
+        painter.drawPixmap(cache->sceneRect, cache->pixmap, cache->pixmap.rect());
+    }
+    else {
+        QGraphicsView::paintEvent(event);
+    }
+
+    const qint64 nsecs = PaintStats::now() - start;
+
+    /* Repaints of the overlay alone are not frames of the plan */
+    const bool refreshOnly = m_hud && m_hudRefresh && m_hud->rect(viewport()->size()).contains(event->rect());
+    m_hudRefresh = false;
+    if (!refreshOnly)
+        emit framePainted(nsecs);
+
+    if (!m_hud)
+        return;
+
+    /* Frames that painted no item end the index lookup here */
+    PaintStats::indexQueryFinished();
+    if (!refreshOnly)
+        m_hud->addFrame(nsecs, PaintStats::takeFrame());
+
+    QPainter painter(viewport());
+    m_hud->draw(&painter, viewport()->size());
+}
+
+/* The view looks up the items to draw right after the background */
+void PlanView::drawBackground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsView::drawBackground(painter, rect);
+    PaintStats::indexQueryStarted();
+}
+
+/* Finds or renders the picture for the nearest zoom level that covers
+ * what is visible. Rendered with room for half a view on every side. */
+const PlanView::ZoomCache *PlanView::zoomCache()
+{
+    if (!scene())
+        return nullptr;
+
+    if (m_cachedScene != scene()) {
+        if (m_cachedScene)
+            disconnect(m_cachedScene, &QGraphicsScene::changed, this, &PlanView::dropZoomCaches);
+        m_zoomCaches.clear();
+        m_cachedScene = scene();
+        connect(m_cachedScene, &QGraphicsScene::changed, this, &PlanView::dropZoomCaches);
+    }
+
+    const int level = zoomLevel(zoom());
+    const QRectF visible = mapToScene(viewport()->rect()).boundingRect();
+
+    for (const ZoomCache &cache : m_zoomCaches)
+        if (cache.level == level && cache.sceneRect.contains(visible))
+            return &cache;
+
+    ZoomCache cache;
+    cache.level = level;
+    cache.sceneRect = visible.adjusted(-visible.width() / 2, -visible.height() / 2,
+                                       visible.width() / 2, visible.height() / 2);
+
+    /* Zoomed far in, the picture would be huge, so it gets coarser */
+    qreal scale = levelZoom(level);
+    const qreal pixels = cache.sceneRect.width() * cache.sceneRect.height() * scale * scale;
+    if (pixels > MaxCachePixels)
+        scale *= qSqrt(MaxCachePixels / pixels);
+
+    const QSize size = (cache.sceneRect.size() * scale).toSize().expandedTo(QSize(1, 1));
+    cache.pixmap = QPixmap(size);
+    cache.pixmap.fill(Qt::transparent);
+
+    /* The picture serves the frames to come, so items draw their full
+     * images rather than the sprites of the zoom going on right now */
+    PlanScene *planScene = qobject_cast<PlanScene*>(scene());
+    const PlanScene::RenderQuality quality = planScene ? planScene->renderQuality()
+                                                       : PlanScene::FullQuality;
+    if (planScene)
+        planScene->setRenderQuality(PlanScene::FullQuality);
+
+    QPainter painter(&cache.pixmap);
+    painter.fillRect(cache.pixmap.rect(), backgroundBrush());
+    painter.setRenderHints(m_fullHints);
+    scene()->render(&painter, QRectF(cache.pixmap.rect()), cache.sceneRect, Qt::IgnoreAspectRatio);
+    painter.end();
+
+    if (planScene)
+        planScene->setRenderQuality(quality);
+
+    if (m_zoomCaches.size() >= MaxZoomCaches)
+        m_zoomCaches.remove(0);
+    m_zoomCaches.append(cache);
+    return &m_zoomCaches.last();
+}
+
+void PlanView::dropZoomCaches()
+{
+    m_zoomCaches.clear();
+}
+
+void PlanView::mousePressEvent(QMouseEvent *event)
+{
+    m_pressed = event->buttons() & Qt::LeftButton;
+    QGraphicsView::mousePressEvent(event);
+}
+
+/* A click alone changes nothing worth degrading for, moving does */
+void PlanView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_pressed)
+        interact();
+    QGraphicsView::mouseMoveEvent(event);
+}
+
+void PlanView::mouseReleaseEvent(QMouseEvent *event)
+{
+    m_pressed = event->buttons() & Qt::LeftButton;
+    QGraphicsView::mouseReleaseEvent(event);
+}
+
+void PlanView::scrollContentsBy(int dx, int dy)
+{
+    interact();
+    QGraphicsView::scrollContentsBy(dx, dy);
+}
+
+void PlanView::interact()
+{
+    if (!m_adaptive)
+        return;
+
+    if (!m_interacting)
+        beginInteraction();
+    m_settleTimer.start();
+}
+
+void PlanView::settle()
+{
+    /* Holding the mouse still mid-drag is not the end of it */
+    if (m_pressed)
+        m_settleTimer.start();
+    else
+        endInteraction();
+}
+
+void PlanView::beginInteraction()
+{
+    m_interacting = true;
+    m_fullHints = renderHints();
+    setRenderHint(QPainter::Antialiasing, false);
+    setRenderHint(QPainter::SmoothPixmapTransform, false);
+    setSceneQuality(true);
+}
+
+void PlanView::endInteraction()
+{
+    m_settleTimer.stop();
+    m_interacting = false;
+    setRenderHints(m_fullHints);
+    setSceneQuality(false);
+
+    /* The one full quality frame */
+    viewport()->update();
+}
+
+void PlanView::setSceneQuality(bool draft)
+{
+    if (PlanScene *planScene = qobject_cast<PlanScene*>(scene()))
+        planScene->setRenderQuality(draft ? PlanScene::DraftQuality : PlanScene::FullQuality);
+}
@@ -0,0 +1,138 @@
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+
+#include "../headers/project_bundle.hpp"
+#include "../headers/project_file.hpp"
+#include "../headers/asset_store.hpp"
+#include "../headers/trace.hpp"
+
+static void setError(QString *errorString, const QString &message)
+{
+    if (errorString)
+        *errorString = message;
+}
+
+bool ProjectBundle::isBundle(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic;
+    in >> magic;
+    return in.status() == QDataStream::Ok && magic == Magic;
+}
+
+bool ProjectBundle::save(const QString &fileName, const QVector<PlanRecord> &records,
+                         QString *errorString)
+{
+    TraceSpan span("ProjectBundle::save", "io");
+    /* Collect every distinct image that is not an application resource */
+    QHash<QString, QString> urlToAsset;     // Original url -> asset url
+    QHash<QByteArray, QByteArray> assets;   // Hash -> compressed image
+    QVector<PlanRecord> bundled = records;
+
+    for (PlanRecord &record : bundled) {
+        const QString url = record.urlPath;
+        if (url.isEmpty() || url.startsWith(":/"))
+            continue;
+
+        auto known = urlToAsset.constFind(url);
+        if (known != urlToAsset.constEnd()) {
+            record.urlPath = *known;
+            continue;
+        }
+
+        QByteArray hash, compressed;
+        if (AssetStore::isAsset(url)) {
+            /* Came from another bundle, already compressed */
+            hash = AssetStore::hashOf(url);
+            compressed = AssetStore::compressedData(url);
+        }
+        else {
+            QFile image(url);
+            if (!image.open(QIODevice::ReadOnly)) {
+                setError(errorString, "Could not read texture " + url);
+                return false;
+            }
+            const QByteArray data = image.readAll();
+            hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+            if (!assets.contains(hash))
+                compressed = qCompress(data);
+        }
+
+        if (!assets.contains(hash))
+            assets.insert(hash, compressed);
+        record.urlPath = AssetStore::urlFor(hash);
+        urlToAsset.insert(url, record.urlPath);
+    }
+
+    /* Project records, in the usual project file format */
+    QBuffer project;
+    project.open(QIODevice::WriteOnly);
+    ProjectWriter writer(&project);
+    writer.writeProject(bundled);
+    project.close();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << Magic << Version << quint32(assets.size());
+    for (auto it = assets.constBegin(); it != assets.constEnd(); ++it)
+        out << it.key() << it.value();
+    out << qCompress(project.data());
+
+    if (out.status() != QDataStream::Ok) {
+        setError(errorString, "Could not write " + fileName);
+        return false;
+    }
+    return true;
+}
+
+bool ProjectBundle::open(const QString &fileName, QByteArray &project, QString *errorString)
+{
+    TraceSpan span("ProjectBundle::open", "io");
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorString, file.errorString());
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, assetCount;
+    in >> magic >> version >> assetCount;
+    if (in.status() != QDataStream::Ok || magic != Magic || version != Version) {
+        setError(errorString, "Not a Home Planner 2D bundle");
+        return false;
+    }
+
+    /* Images stay compressed until something draws them */
+    for (quint32 i = 0; i < assetCount; i++) {
+        QByteArray hash, compressed;
+        in >> hash >> compressed;
+        if (in.status() != QDataStream::Ok)
+            break;
+        AssetStore::add(hash, compressed);
+    }
+
+    QByteArray compressedProject;
+    in >> compressedProject;
+    if (in.status() != QDataStream::Ok) {
+        setError(errorString, "Corrupted bundle " + fileName);
+        return false;
+    }
+
+    project = qUncompress(compressedProject);
+    return true;
+}
@@ -0,0 +1,445 @@
+#include <QFile>
+#include <QSet>
+
+#include "../headers/project_file.hpp"
+#include "../headers/trace.hpp"
+
+/* Header field positions, used when the header is patched */
+static const qint64 ItemCountPos   = 8;
+static const qint64 IndexOffsetPos = 12;
+/* Magic, version, item count and index offset */
+static const qint64 HeaderSize     = 20;
+
+static bool readChunkRecords(QDataStream &in, QVector<PlanRecord> &records)
+{
+    quint8 type;
+    quint32 count;
+    in >> type >> count;
+
+    if (in.status() != QDataStream::Ok || type != ProjectFile::RecordChunk
+            || count > quint32(ProjectFile::ChunkSize))
+        return false;
+
+    records.resize(int(count));
+    for (PlanRecord &record : records)
+        in >> record;
+
+    return in.status() == QDataStream::Ok;
+}
+
+static QVector<quint64> recordIds(const QVector<PlanRecord> &records)
+{
+    QVector<quint64> ids;
+    ids.reserve(records.size());
+    for (const PlanRecord &record : records)
+        ids.append(record.id);
+    return ids;
+}
+
+/* Layout */
+
+void ProjectLayout::clear()
+{
+    chunkOffsets.clear();
+    chunkBytes.clear();
+    chunkIds.clear();
+    chunkOf.clear();
+    deadBytes = 0;
+    converted = false;
+}
+
+void ProjectLayout::setChunk(int chunk, qint64 offset, qint64 bytes, const QVector<quint64> &ids)
+{
+    if (chunk == chunkOffsets.size()) {
+        chunkOffsets.append(offset);
+        chunkBytes.append(bytes);
+        chunkIds.append(ids);
+    }
+    else {
+        for (quint64 id : chunkIds.at(chunk))
+            chunkOf.remove(id);
+
+        chunkOffsets[chunk] = offset;
+        chunkBytes[chunk] = bytes;
+        chunkIds[chunk] = ids;
+    }
+
+    for (quint64 id : ids)
+        chunkOf.insert(id, chunk);
+}
+
+int ProjectLayout::itemCount() const
+{
+    return chunkOf.size();
+}
+
+qint64 ProjectLayout::liveBytes() const
+{
+    qint64 bytes = 0;
+    for (qint64 b : chunkBytes)
+        bytes += b;
+    return bytes;
+}
+
+bool ProjectLayout::needsCompaction() const
+{
+    return converted || deadBytes > liveBytes();
+}
+
+/* Writer */
+
+ProjectWriter::ProjectWriter(QIODevice *device)
+    : m_device(device), m_out(device)
+{
+    m_out.setVersion(QDataStream::Qt_5_12);
+}
+
+qint64 ProjectWriter::writeChunk(const QVector<PlanRecord> &records)
+{
+    const qint64 offset = m_device->pos();
+
+    m_out << quint8(ProjectFile::RecordChunk) << quint32(records.size());
+    for (const PlanRecord &record : records)
+        m_out << record;
+
+    return offset;
+}
+
+/* Appends the index at the current position and points the header to it */
+void ProjectWriter::writeIndex(const ProjectLayout &layout, int itemCount)
+{
+    const qint64 indexOffset = m_device->pos();
+
+    quint32 live = 0;
+    for (qint64 offset : layout.chunkOffsets) {
+        if (offset >= 0)
+            live++;
+    }
+
+    m_out << live;
+    for (qint64 offset : layout.chunkOffsets) {
+        if (offset >= 0)
+            m_out << offset;
+    }
+    const qint64 end = m_device->pos();
+
+    m_device->seek(ItemCountPos);
+    m_out << quint32(itemCount);
+    m_device->seek(IndexOffsetPos);
+    m_out << indexOffset;
+    m_device->seek(end);
+}
+
+void ProjectWriter::writeProject(const QVector<PlanRecord> &records, ProjectLayout *layout)
+{
+    ProjectLayout local;
+    ProjectLayout &l = layout ? *layout : local;
+    l.clear();
+
+    m_out << ProjectFile::Magic << ProjectFile::Version
+          << quint32(records.size()) << qint64(0);
+
+    for (int first = 0; first < records.size(); first += ProjectFile::ChunkSize) {
+        const QVector<PlanRecord> chunk = records.mid(first, ProjectFile::ChunkSize);
+        const qint64 offset = writeChunk(chunk);
+        l.setChunk(l.chunkOffsets.size(), offset, m_device->pos() - offset, recordIds(chunk));
+    }
+
+    writeIndex(l, records.size());
+}
+
+bool ProjectWriter::hasError() const
+{
+    return m_out.status() != QDataStream::Ok;
+}
+
+bool ProjectWriter::save(const QString &fileName, const QVector<PlanRecord> &records,
+                         QString *errorString, ProjectLayout *layout)
+{
+    TraceSpan span("ProjectWriter::save", "io");
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+
+    ProjectWriter writer(&file);
+    writer.writeProject(records, layout);
+
+    if (writer.hasError()) {
+        if (errorString)
+            *errorString = "Could not write " + fileName;
+        return false;
+    }
+    return true;
+}
+
+bool ProjectWriter::saveChanges(const QString &fileName, ProjectLayout &layout,
+                                const QVector<PlanRecord> &changed,
+                                const QVector<quint64> &removed,
+                                QString *errorString)
+{
+    TraceSpan span("ProjectWriter::saveChanges", "io");
+    /* A version 1 header has no index offset to patch */
+    if (layout.converted) {
+        if (errorString)
+            *errorString = fileName + " is an old project file, it has to be saved whole";
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadWrite)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+    ProjectWriter writer(&file);
+
+    /* Find out which chunks are touched, records not in the file yet are new */
+    QHash<quint64, PlanRecord> changedById;
+    QSet<quint64> removedIds;
+    QSet<int> touched;
+    QVector<PlanRecord> fresh;
+
+    for (const PlanRecord &record : changed) {
+        changedById.insert(record.id, record);
+        auto it = layout.chunkOf.constFind(record.id);
+        if (it != layout.chunkOf.constEnd())
+            touched.insert(*it);
+        else
+            fresh.append(record);
+    }
+    for (quint64 id : removed) {
+        if (changedById.contains(id))
+            continue;
+        removedIds.insert(id);
+        auto it = layout.chunkOf.constFind(id);
+        if (it != layout.chunkOf.constEnd())
+            touched.insert(*it);
+    }
+
+    /* The current index becomes garbage, new data goes after it */
+    qint64 oldIndexBytes = sizeof(quint32);
+    for (qint64 offset : layout.chunkOffsets) {
+        if (offset >= 0)
+            oldIndexBytes += sizeof(qint64);
+    }
+    qint64 end = file.size();
+
+    for (int chunk : touched) {
+        QVector<PlanRecord> records;
+        file.seek(layout.chunkOffsets.at(chunk));
+        if (!readChunkRecords(in, records)) {
+            if (errorString)
+                *errorString = "Corrupted project chunk in " + fileName;
+            return false;
+        }
+
+        QVector<PlanRecord> updated;
+        updated.reserve(records.size());
+        for (const PlanRecord &record : records) {
+            if (changedById.contains(record.id))
+                updated.append(changedById.value(record.id));
+            else if (!removedIds.contains(record.id))
+                updated.append(record);
+        }
+
+        layout.deadBytes += layout.chunkBytes.at(chunk);
+        if (updated.isEmpty()) {
+            layout.setChunk(chunk, -1, 0, QVector<quint64>());
+            continue;
+        }
+
+        file.seek(end);
+        const qint64 offset = writer.writeChunk(updated);
+        end = file.pos();
+        layout.setChunk(chunk, offset, end - offset, recordIds(updated));
+    }
+
+    file.seek(end);
+    for (int first = 0; first < fresh.size(); first += ProjectFile::ChunkSize) {
+        const QVector<PlanRecord> chunk = fresh.mid(first, ProjectFile::ChunkSize);
+        const qint64 offset = writer.writeChunk(chunk);
+        layout.setChunk(layout.chunkOffsets.size(), offset, file.pos() - offset, recordIds(chunk));
+    }
+
+    layout.deadBytes += oldIndexBytes;
+    writer.writeIndex(layout, layout.itemCount());
+
+    if (writer.hasError() || !file.flush()) {
+        if (errorString)
+            *errorString = "Could not write " + fileName;
+        return false;
+    }
+    return true;
+}
+
+/* Reader */
+
+ProjectReader::ProjectReader(QIODevice *device)
+    : m_device(device), m_in(device), m_itemCount(0), m_nextChunk(0)
+{
+    m_in.setVersion(QDataStream::Qt_5_12);
+}
+
+bool ProjectReader::readHeader()
+{
+    quint32 magic, version, count;
+    m_in >> magic >> version >> count;
+
+    if (m_in.status() != QDataStream::Ok || magic != ProjectFile::Magic) {
+        m_error = "Not a Home Planner 2D project";
+        return false;
+    }
+    if (version > ProjectFile::Version) {
+        m_error = "Project was saved by a newer version of Home Planner 2D";
+        return false;
+    }
+    if (version == 0) {
+        m_error = "Unsupported project version 0";
+        return false;
+    }
+
+    m_layout.clear();
+    if (version >= ProjectFile::IndexVersion) {
+        /* Checked against the file before anything is allocated or read,
+         * so a broken header cannot ask for gigabytes */
+        const qint64 size = m_device->size();
+        qint64 indexOffset;
+        m_in >> indexOffset;
+        if (m_in.status() != QDataStream::Ok || indexOffset < HeaderSize
+                || indexOffset > size - qint64(sizeof(quint32))) {
+            m_error = "Corrupted project header, the chunk index is outside the file";
+            return false;
+        }
+
+        m_device->seek(indexOffset);
+        quint32 chunks;
+        m_in >> chunks;
+        if (m_in.status() != QDataStream::Ok
+                || qint64(chunks) > (size - m_device->pos()) / qint64(sizeof(qint64))) {
+            m_error = "Corrupted project index, it lists more chunks than the file holds";
+            return false;
+        }
+
+        m_index.resize(int(chunks));
+        for (qint64 &offset : m_index)
+            m_in >> offset;
+    }
+    else {
+        indexChunks();
+        /* Nothing to patch in the old header, the next save writes the
+         * whole file in the current version */
+        m_layout.converted = true;
+    }
+
+    if (m_in.status() != QDataStream::Ok) {
+        m_error = "Corrupted project index";
+        return false;
+    }
+    /* Callers reserve room for this many records */
+    if (qint64(count) > qint64(m_index.size()) * ProjectFile::ChunkSize) {
+        m_error = "Corrupted project header, the item count does not match the chunks";
+        return false;
+    }
+
+    m_itemCount = int(count);
+    m_nextChunk = 0;
+    return true;
+}
+
+/* Version 1 files have no index, their chunks run to the end of the file */
+void ProjectReader::indexChunks()
+{
+    m_index.clear();
+    QVector<PlanRecord> records;
+    while (!m_device->atEnd()) {
+        const qint64 offset = m_device->pos();
+        if (!readChunkRecords(m_in, records)) {
+            m_in.setStatus(QDataStream::ReadCorruptData);
+            return;
+        }
+        m_index.append(offset);
+    }
+}
+
+int ProjectReader::itemCount() const
+{
+    return m_itemCount;
+}
+
+bool ProjectReader::readChunk(QVector<PlanRecord> &records)
+{
+    records.clear();
+    if (!m_error.isEmpty() || m_nextChunk >= m_index.size())
+        return false;
+
+    const qint64 offset = m_index.at(m_nextChunk++);
+    if (!m_device->seek(offset) || !readChunkRecords(m_in, records)) {
+        m_error = "Corrupted project chunk";
+        records.clear();
+        return false;
+    }
+
+    /* Reading a chunk again replaces what the layout has for it */
+    m_layout.setChunk(m_nextChunk - 1, offset, m_device->pos() - offset, recordIds(records));
+    return true;
+}
+
+bool ProjectReader::rewind()
+{
+    if (!m_error.isEmpty())
+        return false;
+    m_nextChunk = 0;
+    return true;
+}
+
+const ProjectLayout &ProjectReader::layout() const
+{
+    return m_layout;
+}
+
+bool ProjectReader::hasError() const
+{
+    return !m_error.isEmpty();
+}
+
+QString ProjectReader::errorString() const
+{
+    return m_error;
+}
+
+bool ProjectReader::load(const QString &fileName, QVector<PlanRecord> &records,
+                         QString *errorString, ProjectLayout *layout)
+{
+    TraceSpan span("ProjectReader::load", "io");
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+
+    ProjectReader reader(&file);
+    if (reader.readHeader()) {
+        records.reserve(reader.itemCount());
+
+        QVector<PlanRecord> chunk;
+        while (reader.readChunk(chunk))
+            records += chunk;
+    }
+
+    if (reader.hasError()) {
+        if (errorString)
+            *errorString = reader.errorString();
+        return false;
+    }
+
+    if (layout)
+        *layout = reader.layout();
+    return true;
+}
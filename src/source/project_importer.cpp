@@ -0,0 +1,219 @@
+#include <QBuffer>
+#include <QFile>
+#include <QScopedPointer>
+
+#include "../headers/project_importer.hpp"
+#include "../headers/project_bundle.hpp"
+#include "../headers/json_interchange.hpp"
+#include "../headers/trace.hpp"
+
+/* At most this many batches wait in the GUI event queue, so a large file
+ * can not flood the event loop and starve painting and input */
+static const int MaxBatchesInFlight = 4;
+
+ImportControl::ImportControl()
+    : m_slots(MaxBatchesInFlight), m_cancelled(false)
+{
+}
+
+void ImportControl::cancel()
+{
+    m_cancelled = true;
+    m_slots.release();      // Wake the worker if it is waiting for a slot
+}
+
+bool ImportControl::isCancelled() const
+{
+    return m_cancelled;
+}
+
+void ImportControl::batchConsumed()
+{
+    m_slots.release();
+}
+
+bool ImportControl::waitForSlot()
+{
+    while (!m_cancelled) {
+        if (m_slots.tryAcquire(1, 50))
+            return !m_cancelled;
+    }
+    return false;
+}
+
+ProjectImporter::ProjectImporter(QString fileName, QRectF visibleRect,
+                                 QSharedPointer<ImportControl> control)
+    : m_fileName(fileName), m_visibleRect(visibleRect), m_control(control)
+{
+    /* Batches cross thread boundaries through queued connections */
+    qRegisterMetaType<QVector<PlanRecord>>();
+    qRegisterMetaType<ProjectLayout>();
+}
+
+bool ProjectImporter::send(QVector<PlanRecord> &batch)
+{
+    if (batch.isEmpty())
+        return true;
+    if (!m_control->waitForSlot())
+        return false;
+
+    emit batchReady(batch);
+    batch.clear();
+    batch.reserve(BatchSize);
+    return true;
+}
+
+void ProjectImporter::run()
+{
+    TraceSpan span("ProjectImporter::run", "io");
+    if (m_fileName.endsWith(".json", Qt::CaseInsensitive))
+        readJson();
+    else
+        readProject();
+}
+
+void ProjectImporter::readProject()
+{
+    /* Bundles carry a compressed project file, unpack it first */
+    QFile file(m_fileName);
+    QBuffer buffer;
+    QIODevice *device = &file;
+    const bool bundle = ProjectBundle::isBundle(m_fileName);
+
+    if (bundle) {
+        QByteArray project;
+        QString error;
+        if (!ProjectBundle::open(m_fileName, project, &error)) {
+            emit finished(false, error);
+            return;
+        }
+        buffer.setData(project);
+        device = &buffer;
+    }
+
+    if (!device->open(QIODevice::ReadOnly)) {
+        emit finished(false, device->errorString());
+        return;
+    }
+
+    ProjectReader reader(device);
+    if (!reader.readHeader()) {
+        emit finished(false, reader.errorString());
+        return;
+    }
+    emit started(reader.itemCount());
+
+    auto readChunk = [&reader](QVector<PlanRecord> &chunk) { return reader.readChunk(chunk); };
+    auto rewind = [&reader]() { return reader.rewind(); };
+    if (!distribute(readChunk, rewind))
+        return;
+
+    if (reader.hasError()) {
+        emit finished(false, reader.errorString());
+        return;
+    }
+
+    /* Bundles are written as a whole, changes can not be saved into them */
+    if (!bundle)
+        emit layoutReady(reader.layout());
+    emit finished(true, QString());
+}
+
+void ProjectImporter::readJson()
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        emit finished(false, file.errorString());
+        return;
+    }
+
+    /* Small files are parsed in one go */
+    if (file.size() <= JsonInterchange::DocumentLimit) {
+        QVector<PlanRecord> records;
+        QString error;
+        if (!JsonInterchange::readDocument(file.readAll(), records, &error)) {
+            emit finished(false, error);
+            return;
+        }
+        emit started(records.size());
+
+        bool pending = true;
+        auto readAll = [&records, &pending](QVector<PlanRecord> &chunk) {
+            if (!pending)
+                return false;
+            chunk = records;
+            pending = false;
+            return true;
+        };
+        auto rewind = [&pending]() { pending = true; return true; };
+        if (distribute(readAll, rewind))
+            emit finished(true, QString());
+        return;
+    }
+
+    /* The item count is not known up front */
+    emit started(0);
+
+    QScopedPointer<JsonPlanReader> reader(new JsonPlanReader(&file));
+    auto readChunk = [&reader](QVector<PlanRecord> &chunk) {
+        chunk.clear();
+        PlanRecord record;
+        while (chunk.size() < BatchSize && reader->readNext(record))
+            chunk.append(record);
+        return !chunk.isEmpty();
+    };
+    /* The second pass parses the file again from the start */
+    auto rewind = [&reader, &file]() {
+        if (reader->hasError() || !file.seek(0))
+            return false;
+        reader.reset(new JsonPlanReader(&file));
+        return true;
+    };
+
+    if (!distribute(readChunk, rewind))
+        return;
+
+    if (reader->hasError()) {
+        emit finished(false, reader->errorString());
+        return;
+    }
+    emit finished(true, QString());
+}
+
+/* Reads the file twice: the first pass sends the records overlapping the
+ * viewport, the second everything else. Only one chunk and one batch are
+ * held at a time, however large the file. Returns false if the import
+ * was cancelled. */
+bool ProjectImporter::distribute(const std::function<bool(QVector<PlanRecord>&)> &readChunk,
+                                 const std::function<bool()> &rewind)
+{
+    QVector<PlanRecord> batch;
+    QVector<PlanRecord> chunk;
+    batch.reserve(BatchSize);
+
+    for (int pass = 0; pass < 2; pass++) {
+        const bool visiblePass = pass == 0;
+        /* A read error ends the import, the caller reports it */
+        if (!visiblePass && !rewind())
+            return true;
+
+        while (readChunk(chunk)) {
+            for (const PlanRecord &record : chunk) {
+                if (m_visibleRect.intersects(record.sceneBoundingRect()) != visiblePass)
+                    continue;
+
+                batch.append(record);
+                if (batch.size() == BatchSize && !send(batch)) {
+                    emit finished(false, "Import cancelled");
+                    return false;
+                }
+            }
+        }
+
+        if (!send(batch)) {
+            emit finished(false, "Import cancelled");
+            return false;
+        }
+    }
+    return true;
+}
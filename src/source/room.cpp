@@ -1,74 +1,158 @@
 #include <QtGui>
 #include <QApplication>
 #include <QDesktopWidget>
+#include <QGraphicsSceneMouseEvent>
 
 #include "../headers/room.hpp"
+#include "../headers/plan_scene.hpp"
+#include "../headers/image_cache.hpp"
+#include "../headers/paint_stats.hpp"
+#include "../headers/trace.hpp"
+
+/* Rooms without a floor texture */
+static const QColor DefaultFloor(175, 175, 175);
+
+/* Drawn around selected rooms */
+static const QPen SelectionOutline(Qt::green, 1);
+
+/* Describes a new room, everything else about it is kept by the model */
+static PlanRecord roomRecord(const PlanRecord &record)
+{
+    PlanRecord room = record;
+    room.kind = PlanRecord::RoomKind;
+    room.flipped = false;
+    /* A duplicate id (broken file) gets a fresh one instead of sharing data */
+    if (PlanModel::detached().contains(room.id))
+        room.id = 0;
+    return room;
+}
+
+static PlanRecord roomRecord(double width, double height, const QString &urlPath)
+{
+    PlanRecord room;
+    room.width = width;
+    room.height = height;
+    room.urlPath = urlPath;
+    room.zValue = -1;
+    return roomRecord(room);
+}
 
 Room::Room(double width, double height, QString urlPath)
-    : m_width(width), m_height(height), m_urlPath(urlPath)
+    : m_model(&PlanModel::detached()),
+      m_id(m_model->add(roomRecord(width, height, urlPath))), m_dirty(false)
 {
-    setFlags(ItemIsMovable | ItemIsFocusable | ItemIsSelectable);
+    setFlags(ItemIsMovable | ItemIsFocusable | ItemIsSelectable | ItemSendsGeometryChanges);
 
-    angle = 0;
     numberRooms++;
 
+    /* Rooms always stay under furniture, no matter in which order they were added */
+    setZValue(-1);
+
     /* Setting position of room to center of scene (screen) */
     int screenWidth  = QApplication::desktop()->width();
     int screenHeight = QApplication::desktop()->height();
     setPos(screenWidth/3, screenHeight/3);
 }
 
+/* Rebuilds a room from a project file, safe to call from any thread */
+Room::Room(const PlanRecord &record)
+    : m_model(&PlanModel::detached()), m_id(m_model->add(roomRecord(record))), m_dirty(false)
+{
+    setFlags(ItemIsMovable | ItemIsFocusable | ItemIsSelectable | ItemSendsGeometryChanges);
+
+    numberRooms++;
+
+    /* The model already knows all of this, the item has to catch up */
+    setPos(record.x, record.y);
+    setZValue(record.zValue);
+    if (!qFuzzyIsNull(record.angle))
+        rotate(record.angle);
+}
+
 Room::~Room()
 {
+    notifyScene(PlanOp::Delete);
+    m_model->remove(m_id);
     numberRooms--;
 //    QGraphicsItem::~QGraphicsItem();
 }
 
 /* Initialization of a static variable */
-int Room::numberRooms= 0;
+std::atomic<int> Room::numberRooms(0);
+
+int Room::type() const {
+    return Type;
+}
+
+quint64 Room::id() const
+{
+    return m_id;
+}
+
+PlanRecord Room::record() const
+{
+    return m_model->record(m_id);
+}
+
+/* Geometry of this room as the model has it */
+const PlanItem &Room::planItem() const
+{
+    static const PlanItem none;
+    const PlanItem *item = m_model->item(m_id);
+    return item ? *item : none;
+}
 
 double Room::getArea() const
 {
-    /* Dividing by 33 because 1m equals 33px */
-    return m_width * m_height / (33 * 33);
+    return m_model->area(m_id);
 }
 
 void Room::setFloorPath(QString urlP)
 {
-    this->m_urlPath = urlP;
+    m_model->setImage(m_id, urlP);
+    update();
+    notifyScene(PlanOp::Floor);
 }
 
 /* Unnecessary function, never used */
 QString Room::floorPath() const
 {
-    return m_urlPath;
+    return m_model->image(planItem());
 }
 
 void Room::rotate(qreal angleParam)
 {
     /* Rotation origin point needs to be moved to the center of the object */
-    setTransformOriginPoint(m_width/2, m_height/2);
-    angle += angleParam;
-    setRotation(angle);
+    const PlanItem &item = planItem();
+    setTransformOriginPoint(item.width/2, item.height/2);
+    setRotation(rotation() + angleParam);
 }
 
 void Room::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
     Q_UNUSED(option); Q_UNUSED(widget);
+    PaintTimer timer(PaintStats::RoomPaint);
+    TraceSpan span("Room::paint", "paint");
+
+    PlanScene *planScene = PlanScene::of(this);
+    const bool draft = planScene && planScene->renderQuality() == PlanScene::DraftQuality;
 
     /* If room is selected, draw green outline around its boundingRect */
     if (isSelected()) {
-        painter->setPen(m_pen);
-        m_pen.setWidth(1);
-        m_pen.setColor(Qt::green);
+        painter->setPen(SelectionOutline);
         painter->drawRect(boundingRect());
     }
 
+    const PlanItem &item = planItem();
+
     /* Is floor texture selected or not ? */
-    if (m_urlPath.isEmpty()) {
+    if (item.image == 0) {
         /* Default grey floor */
-        QColor *myColor = new QColor(175, 175, 175, 255);
-        painter->fillRect(boundingRect(), myColor->rgb());
+        painter->fillRect(boundingRect(), DefaultFloor);
+    }
+    else if (draft) {
+        /* The texture's average color, tiling it costs too much mid-drag */
+        painter->fillRect(boundingRect(), ImageCache::averageColor(m_model->image(item)));
     }
     else {
         /* The user has chosen a floor texture, setFloorPath has been set
@@ -76,56 +160,143 @@ void Room::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWid
 
         /* Instead of fixed values for scale, this could be parametrized.
          * This may be a reason why some textures are low resolution. */
-        QBrush brush(QPixmap(m_urlPath).scaled(35, 35));
-        painter->setBrush(brush);
+        painter->setBrush(ImageCache::floorBrush(m_model->image(item)));
         painter->drawRect(boundingRect());
     }
 
-    /* m_width and m_height are doubles, need to be int */
-    painter->drawRect(0, 0, static_cast<int>(m_width), static_cast<int>(m_height) );
+    /* Width and height are floats, need to be int */
+    painter->drawRect(0, 0, static_cast<int>(item.width), static_cast<int>(item.height) );
 }
 
 QRectF Room::boundingRect() const
 {
-    return QRectF(0,0, m_width, m_height);
+    const PlanItem &item = planItem();
+    return QRectF(0,0, item.width, item.height);
 }
 
+/* Arrows move the focused item, see NudgeController */
 void Room::keyPressEvent(QKeyEvent *event)
 {
-    /* Translation + SHIFT = 10px, else 1px */
-    bool shiftPressed = event->modifiers() & Qt::ShiftModifier;
+    PlanScene *planScene = PlanScene::of(this);
+    if (!planScene || !planScene->nudge().keyPressed(this, event))
+        QGraphicsItem::keyPressEvent(event);
+}
+
+void Room::keyReleaseEvent(QKeyEvent *event)
+{
+    PlanScene *planScene = PlanScene::of(this);
+    if (!planScene || !planScene->nudge().keyReleased(event))
+        QGraphicsItem::keyReleaseEvent(event);
+}
+
+/* A locked room lets the press through, so dragging it pans the view */
+void Room::mousePressEvent(QGraphicsSceneMouseEvent *event)
+{
+    PlanScene *planScene = PlanScene::of(this);
+    if (planScene && planScene->roomsLocked())
+        event->ignore();
+    else
+        QGraphicsItem::mousePressEvent(event);
+}
+
+bool Room::isDirty() const
+{
+    return m_dirty;
+}
+
+void Room::clearDirty()
+{
+    m_dirty = false;
+}
+
+/* Registers the item with its scene once per save, not on every change */
+void Room::markDirty()
+{
+    PlanScene *planScene = PlanScene::of(this);
+    if (m_dirty || !planScene)
+        return;
+
+    m_dirty = true;
+    planScene->markDirty(m_id, this);
+}
+
+/* Moves the room's data into the model of the scene it is now in */
+void Room::followScene()
+{
+    PlanScene *planScene = PlanScene::of(this);
+    PlanModel *target = planScene ? &planScene->model() : &PlanModel::detached();
+    if (target == m_model)
+        return;
+
+    PlanRecord r = m_model->record(m_id);
+    m_model->remove(m_id);
+    if (target->contains(r.id))
+        r.id = 0;
+    m_id = target->add(r);
+    m_model = target;
+}
+
+/* Reports changes to the plan scene, which passes them on to autosave */
+void Room::notifyScene(PlanOp::Type type)
+{
+    PlanScene *planScene = PlanScene::of(this);
+    if (!planScene)
+        return;
+
+    if (type == PlanOp::Delete) {
+        planScene->markRemoved(m_id);
+        m_dirty = false;
+    }
+    else {
+        markDirty();
+    }
+
+    planScene->itemChanged(this, type, record());
+}
+
+QVariant Room::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    PlanScene *planScene = PlanScene::of(this);
 
-    switch ( event->key() )
+    switch (change)
     {
-        /* Moving */
-        case Qt::Key_Right:
-            if (shiftPressed)
-                moveBy(5, 0);
-            else
-                moveBy(1, 0);
+        /* Rooms stay as they are while furnishing */
+        case ItemPositionChange:
+            if (planScene && planScene->roomsLocked())
+                return pos();
             break;
-
-        case Qt::Key_Left:
-            if (shiftPressed)
-                moveBy(-5, 0);
-            else
-                moveBy(-1, 0);
+        case ItemSelectedChange:
+            if (planScene && planScene->roomsLocked() && value.toBool())
+                return false;
             break;
-
-        case Qt::Key_Up:
-            if (shiftPressed)
-                moveBy(0, -5);
-            else
-                moveBy(0, -1);
+        case ItemPositionHasChanged:
+            m_model->setPosition(m_id, pos().x(), pos().y());
+            notifyScene(PlanOp::Move);
             break;
-
-        case Qt::Key_Down:
-            if (shiftPressed)
-                moveBy(0, 5);
-            else
-                moveBy(0, 1);
+        case ItemRotationHasChanged:
+            m_model->setAngle(m_id, rotation());
+            notifyScene(PlanOp::Rotate);
+            break;
+        /* Leaving a scene counts as deletion there, entering one as adding */
+        case ItemSceneChange:
+            notifyScene(PlanOp::Delete);
+            break;
+        case ItemSceneHasChanged:
+            followScene();
+            notifyScene(PlanOp::Add);
+            break;
+        case ItemSelectedHasChanged:
+            if (planScene)
+                planScene->itemSelectionChanged(this, value.toBool());
+            break;
+        /* Stacking is saved too, but not journaled */
+        case ItemZValueHasChanged:
+            m_model->setZValue(m_id, zValue());
+            markDirty();
+            break;
+        default:
             break;
     }
 
-    this->update();
+    return QGraphicsItem::itemChange(change, value);
 }
@@ -0,0 +1,62 @@
+#include <QElapsedTimer>
+#include <QSet>
+
+#include <cstdio>
+
+#include "../headers/startup_timer.hpp"
+#include "../headers/trace.hpp"
+
+namespace {
+
+struct StartupClock
+{
+    /* Started with the other static objects, before main() */
+    StartupClock() : enabled(qEnvironmentVariableIsSet("HOMEPLANNER_STARTUP")),
+        last(0), lastTrace(0) { clock.start(); }
+
+    QElapsedTimer clock;
+    const bool enabled;
+    QSet<const char*> reached;
+    double last;
+    double lastTrace;
+};
+
+StartupClock &startupClock()
+{
+    static StartupClock clock;
+    return clock;
+}
+
+/* Constructs the clock during static initialization, not on first use */
+const StartupClock &s_clock = startupClock();
+
+}
+
+bool StartupTimer::isEnabled()
+{
+    return startupClock().enabled;
+}
+
+double StartupTimer::elapsed()
+{
+    return startupClock().clock.nsecsElapsed() / 1e6;
+}
+
+void StartupTimer::mark(const char *milestone)
+{
+    StartupClock &clock = startupClock();
+    if ((!clock.enabled && !Trace::isEnabled()) || clock.reached.contains(milestone))
+        return;
+    clock.reached.insert(milestone);
+
+    const double now = elapsed();
+    if (clock.enabled)
+        std::fprintf(stderr, "Startup %8.1f ms (+%.1f ms)  %s\n", now, now - clock.last, milestone);
+    clock.last = now;
+
+    if (Trace::isEnabled()) {
+        const double traceNow = Trace::now();
+        Trace::addSpan(milestone, "startup", clock.lastTrace, traceNow - clock.lastTrace);
+        clock.lastTrace = traceNow;
+    }
+}
@@ -0,0 +1,157 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+#include "../headers/trace.hpp"
+
+const bool Trace::s_enabled = qEnvironmentVariableIsSet("HOMEPLANNER_TRACE");
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    const char *category;
+    double start;
+    double duration;
+};
+
+struct ThreadBuffer
+{
+    int tid;
+    QByteArray threadName;
+    QVector<TraceEvent> events;
+};
+
+struct TraceLog;
+bool writeLog(TraceLog &log);
+
+/* Buffers outlive their threads, they are written at exit */
+struct TraceLog
+{
+    TraceLog() { clock.start(); }
+    ~TraceLog()
+    {
+        if (Trace::isEnabled())
+            writeLog(*this);
+        qDeleteAll(buffers);
+    }
+
+    QElapsedTimer clock;
+    QMutex mutex;
+    QVector<ThreadBuffer*> buffers;
+};
+
+}
+
+static TraceLog &traceLog()
+{
+    static TraceLog log;
+    return log;
+}
+
+/* Registered once per thread, after that appending takes no lock */
+static ThreadBuffer *threadBuffer()
+{
+    static thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer)
+        return buffer;
+
+    TraceLog &log = traceLog();
+    QMutexLocker locker(&log.mutex);
+
+    buffer = new ThreadBuffer;
+    buffer->tid = log.buffers.size() + 1;
+    QThread *thread = QThread::currentThread();
+    if (!thread->objectName().isEmpty())
+        buffer->threadName = thread->objectName().toUtf8();
+    else if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+        buffer->threadName = "main";
+    else
+        buffer->threadName = "thread " + QByteArray::number(buffer->tid);
+    buffer->events.reserve(4096);
+    log.buffers.append(buffer);
+    return buffer;
+}
+
+double Trace::now()
+{
+    return traceLog().clock.nsecsElapsed() / 1000.0;
+}
+
+void Trace::addSpan(const char *name, const char *category, double start, double duration)
+{
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.start = start;
+    event.duration = duration;
+    threadBuffer()->events.append(event);
+}
+
+static QByteArray number(double value)
+{
+    return QByteArray::number(value, 'f', 3);
+}
+
+bool Trace::write()
+{
+    return writeLog(traceLog());
+}
+
+namespace {
+
+/* Complete events ("ph": "X") carry begin and end in one record */
+bool writeLog(TraceLog &log)
+{
+    QString fileName = QString::fromLocal8Bit(qgetenv("HOMEPLANNER_TRACE"));
+    if (fileName.isEmpty() || fileName == "1")
+        fileName = "homeplanner_trace.json";
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QMutexLocker locker(&log.mutex);
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    bool first = true;
+    for (const ThreadBuffer *buffer : log.buffers) {
+        const QByteArray tid = QByteArray::number(buffer->tid);
+
+        /* Thread names are set by anyone, QJsonDocument escapes them */
+        QJsonObject args;
+        args["name"] = QString::fromUtf8(buffer->threadName);
+        QJsonObject metadata;
+        metadata["ph"] = "M";
+        metadata["name"] = "thread_name";
+        metadata["pid"] = double(QCoreApplication::applicationPid());
+        metadata["tid"] = buffer->tid;
+        metadata["args"] = args;
+        const QByteArray line = QJsonDocument(metadata).toJson(QJsonDocument::Compact);
+        file.write(first ? line : ",\n" + line);
+        first = false;
+
+        for (const TraceEvent &event : buffer->events) {
+            file.write(",\n{\"ph\":\"X\",\"name\":\"");
+            file.write(event.name);
+            file.write("\",\"cat\":\"");
+            file.write(event.category);
+            file.write("\",\"ts\":" + number(event.start) + ",\"dur\":" + number(event.duration)
+                       + ",\"pid\":" + pid + ",\"tid\":" + tid + "}");
+        }
+    }
+
+    file.write("\n]}\n");
+    return file.error() == QFile::NoError;
+}
+
+}
@@ -0,0 +1,202 @@
+#include <QApplication>
+#include <QEvent>
+
+#include "../headers/window_manager.hpp"
+#include "../headers/main_menu_window.hpp"
+#include "../headers/memory_stats.hpp"
+#include "../headers/startup_timer.hpp"
+#include "../headers/trace.hpp"
+
+WindowManager *WindowManager::instance()
+{
+    static QPointer<WindowManager> manager;
+    if (!manager)
+        manager = new WindowManager(qApp);
+    return manager;
+}
+
+WindowManager::WindowManager(QObject *parent)
+    : QObject(parent), m_quitting(false), m_prewarmScheduled(false), m_templateFresh(false)
+{
+    /* Widgets must go while QApplication is still whole */
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &WindowManager::shutdown);
+
+    connect(&m_idleTimer, &QTimer::timeout, this, &WindowManager::trimIdle);
+    m_idleTimer.start(IdleCheckInterval);
+}
+
+/* Builds the window the first time, otherwise takes it off the hidden list */
+template <class Window>
+Window *WindowManager::window(QPointer<Window> &slot)
+{
+    if (!slot) {
+        slot = new Window;
+        slot->installEventFilter(this);
+    }
+    m_hidden.remove(slot);
+    return slot;
+}
+
+void WindowManager::showMainMenu()
+{
+    MainMenuWindow *menu = window(m_mainMenu);
+    menu->reset();
+    menu->show();
+}
+
+void WindowManager::showInstructions()
+{
+    Instructions *instructions = window(m_instructions);
+    if (!instructions->isVisible())
+        instructions->reset();
+    instructions->show();
+    instructions->raise();
+    instructions->activateWindow();
+}
+
+void WindowManager::showDesign()
+{
+    const bool created = !m_design;
+    DesignWindow *design = window(m_design);
+    if (!created)
+        design->reset();
+    design->show();
+}
+
+void WindowManager::showTemplate(PlanScene *plan)
+{
+    StartupTimer::mark("furnishing window requested");
+
+    if (!m_template) {
+        m_template = new TemplateWindow(nullptr, plan);
+        m_template->installEventFilter(this);
+    }
+    /* A prewarmed window already has the default apartment */
+    else if (!m_templateFresh || plan) {
+        m_hidden.remove(m_template);
+        m_template->reset(plan);
+    }
+    m_templateFresh = false;
+    m_template->show();
+}
+
+/* The scene first, the catalog in a later turn of the event loop, so the
+ * menu stays responsive in between */
+void WindowManager::prewarm()
+{
+    if (m_template || !m_mainMenu || !m_mainMenu->isVisible())
+        return;
+
+    TraceSpan span("WindowManager::prewarm", "startup");
+    m_template = new TemplateWindow;
+    m_template->installEventFilter(this);
+    m_templateFresh = true;
+    QTimer::singleShot(0, m_template.data(), &TemplateWindow::buildCatalog);
+}
+
+void WindowManager::quit()
+{
+    m_quitting = true;
+    QApplication::closeAllWindows();
+
+    /* A replay keeps the application running without windows */
+    if (!QApplication::quitOnLastWindowClosed())
+        QApplication::quit();
+}
+
+bool WindowManager::isEditingWindow(const QObject *object) const
+{
+    return object && (object == m_design.data() || object == m_template.data());
+}
+
+bool WindowManager::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+        case QEvent::Paint:
+            if (watched == m_mainMenu.data()) {
+                StartupTimer::mark("main menu painted");
+                if (!m_prewarmScheduled) {
+                    m_prewarmScheduled = true;
+                    QTimer::singleShot(PrewarmDelay, this, &WindowManager::prewarm);
+                }
+            }
+            else if (watched == m_template.data()) {
+                StartupTimer::mark("furnishing window painted");
+            }
+            break;
+        /* Shown before the editing window goes, so the application does
+         * not take it for its last window */
+        case QEvent::Close:
+            if (!m_quitting && isEditingWindow(watched))
+                showMainMenu();
+            break;
+        case QEvent::Hide:
+            if (!event->spontaneous())
+                windowHidden(static_cast<QWidget*>(watched));
+            break;
+        case QEvent::Show:
+            m_hidden.remove(static_cast<QWidget*>(watched));
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+
+void WindowManager::windowHidden(QWidget *window)
+{
+    if (window == m_mainMenu.data() || m_quitting)
+        return;
+
+    m_hidden[window].start();
+
+    qint64 bytes = 0;
+    const MemoryStats::Snapshot snapshot = MemoryStats::take();
+    for (int kind = 0; kind < MemoryStats::KindCount; kind++)
+        bytes += snapshot[MemoryStats::Kind(kind)].bytes;
+    if (bytes > MemoryBudget)
+        QTimer::singleShot(0, this, &WindowManager::trim);
+}
+
+/* The next request builds the window again from scratch. Only called from
+ * timers, never from inside the window's own event handling. */
+void WindowManager::release(QWidget *window)
+{
+    m_hidden.remove(window);
+    delete window;
+}
+
+/* The plans of the freed windows leave assets, images and pool chunks
+ * behind, those go as well */
+void WindowManager::trim()
+{
+    const QList<QWidget*> hidden = m_hidden.keys();
+    for (QWidget *window : hidden)
+        if (!window->isVisible())
+            release(window);
+    MemoryStats::trim();
+}
+
+void WindowManager::trimIdle()
+{
+    bool released = false;
+    const QList<QWidget*> hidden = m_hidden.keys();
+    for (QWidget *window : hidden) {
+        if (!window->isVisible() && m_hidden.value(window).elapsed() >= IdleTimeout) {
+            release(window);
+            released = true;
+        }
+    }
+    if (released)
+        MemoryStats::trim();
+}
+
+void WindowManager::shutdown()
+{
+    m_quitting = true;
+    m_hidden.clear();
+    delete m_template;
+    delete m_design;
+    delete m_instructions;
+    delete m_mainMenu;
+}
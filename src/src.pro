@@ -12,34 +12,53 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 CONFIG += c++11
 
+include(scene.pri)
+
 SOURCES += \
         source/main.cpp \
         source/main_menu_window.cpp \
         source/template_window.cpp \
         source/design_window.cpp \
         source/centered_window.cpp \
-        source/furniture.cpp \
-        source/room.cpp \
-        source/instructions.cpp
+        source/instructions.cpp \
+        source/project_importer.cpp \
+        source/autosave_journal.cpp \
+        source/plan_history.cpp \
+        source/plan_versions.cpp \
+        source/plan_view.cpp \
+        source/plan_hud.cpp \
+        source/input_recorder.cpp \
+        source/input_replayer.cpp \
+        source/memory_panel.cpp \
+        source/window_manager.cpp \
+        source/furniture_catalog.cpp
 
 HEADERS += \
         headers/main_menu_window.hpp \
         headers/template_window.hpp \
         headers/design_window.hpp \
         headers/centered_window.hpp \
-        headers/furniture.hpp \
-        headers/room.hpp \
-        headers/instructions.hpp
+        headers/instructions.hpp \
+        headers/project_importer.hpp \
+        headers/autosave_journal.hpp \
+        headers/plan_history.hpp \
+        headers/plan_versions.hpp \
+        headers/plan_view.hpp \
+        headers/plan_hud.hpp \
+        headers/input_recorder.hpp \
+        headers/input_replayer.hpp \
+        headers/memory_panel.hpp \
+        headers/window_manager.hpp \
+        headers/furniture_catalog.hpp
 
 FORMS += \
         ui/main_menu_window.ui \
         ui/template_window.ui \
         ui/design_window.ui \
-        ui/instructions.ui
+        ui/instructions.ui \
+        ui/furniture_catalog.ui
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
-
-RESOURCES += resources.qrc
@@ -0,0 +1,151 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+
+#include "plan_analysis.hpp"
+#include "plan_loader.hpp"
+
+/*
+ * Checks plans for overlapping items and furniture outside of rooms and
+ * collects their area and furniture counts, as one JSON report:
+ *
+ *   analyze_plans [-o <report.json>] [-j <jobs>] <file or directory>...
+ *
+ * Works on plan records alone and links only the QtCore plan library,
+ * so nothing can be drawn and no window can be opened.
+ * The exit code is 1 when a plan could not be read or has issues.
+ */
+
+class AnalyzeJob : public QRunnable
+{
+public:
+    /* Every job owns its own slot in the results, no locking needed */
+    AnalyzeJob(const QString &fileName, QJsonObject *result)
+        : m_fileName(fileName), m_result(result)
+    {
+    }
+
+    void run() override
+    {
+        QVector<PlanRecord> records;
+        QString error;
+
+        if (PlanLoader::load(m_fileName, records, &error))
+            *m_result = PlanAnalysis::analyze(records).toJson();
+        else
+            (*m_result)["error"] = error;
+
+        (*m_result)["file"] = m_fileName;
+    }
+
+private:
+    QString m_fileName;
+    QJsonObject *m_result;
+};
+
+static QStringList collectPlans(const QStringList &paths)
+{
+    const QStringList filters = { "*.hp2d", "*.hp2b", "*.json" };
+    QStringList plans;
+
+    for (const QString &path : paths) {
+        if (!QFileInfo(path).isDir()) {
+            plans.append(path);
+            continue;
+        }
+
+        QDirIterator it(path, filters, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            plans.append(it.next());
+    }
+    return plans;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("analyze_plans");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Validates Home Planner 2D plans and reports their contents.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("plans", "Plan files or directories containing them.",
+                                 "<plan>...");
+
+    QCommandLineOption outputOption({ "o", "output" },
+        "Write the report to <file> instead of standard output.", "file");
+    QCommandLineOption jobsOption({ "j", "jobs" },
+        "Check <n> plans at once, defaults to the number of cores.", "n",
+        QString::number(QThread::idealThreadCount()));
+    parser.addOptions({ outputOption, jobsOption });
+    parser.process(app);
+
+    const int jobs = parser.value(jobsOption).toInt();
+    if (jobs <= 0) {
+        QTextStream(stderr) << "Jobs must be positive" << '\n';
+        return 2;
+    }
+
+    const QStringList plans = collectPlans(parser.positionalArguments());
+    if (plans.isEmpty())
+        parser.showHelp(2);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    /* Sized up front, so the slots handed to the jobs never move */
+    QVector<QJsonObject> results(plans.size());
+    QJsonObject *slot = results.data();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs);
+    for (int i = 0; i < plans.size(); i++)
+        pool.start(new AnalyzeJob(plans.at(i), slot + i));
+    pool.waitForDone();
+
+    int failed = 0, invalid = 0;
+    QJsonArray reports;
+    for (const QJsonObject &result : results) {
+        if (result.contains("error"))
+            failed++;
+        else if (!result.value("valid").toBool())
+            invalid++;
+        reports.append(result);
+    }
+
+    QJsonObject summary;
+    summary["plans"] = plans.size();
+    summary["failed"] = failed;
+    summary["invalid"] = invalid;
+    summary["seconds"] = timer.elapsed() / 1000.0;
+
+    QJsonObject root;
+    root["summary"] = summary;
+    root["plans"] = reports;
+    const QByteArray json = QJsonDocument(root).toJson();
+
+    const QString outputName = parser.value(outputOption);
+    if (outputName.isEmpty()) {
+        QFile output;
+        output.open(stdout, QIODevice::WriteOnly);
+        output.write(json);
+    }
+    else {
+        QFile output(outputName);
+        if (!output.open(QIODevice::WriteOnly) || output.write(json) != json.size()) {
+            QTextStream(stderr) << "Could not write " << outputName << '\n';
+            return 2;
+        }
+    }
+
+    return failed > 0 || invalid > 0 ? 1 : 0;
+}
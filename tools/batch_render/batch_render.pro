@@ -0,0 +1,11 @@
+QT += core gui widgets
+
+TARGET = batch_render
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../../src/scene.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,180 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+
+#include "plan_loader.hpp"
+#include "plan_scene.hpp"
+
+/*
+ * Renders plans to PNG images without opening any window:
+ *
+ *   batch_render [-o <dir>] [-j <jobs>] [-s <scale>] [-m <margin>] <file or directory>...
+ *
+ * Directories are searched recursively for *.hp2d, *.hp2b and *.json plans.
+ * Every plan is drawn by the same Room and Furniture code as the planner,
+ * one plan per thread pool job.
+ */
+
+struct RenderOptions
+{
+    QString outputDir;      // Empty means next to the plan
+    qreal scale = 1;
+    int margin = 10;
+};
+
+struct RenderTotals
+{
+    std::atomic<int> rendered{0};
+    std::atomic<int> failed{0};
+    std::atomic<qint64> items{0};
+    QMutex outputMutex;     // Keeps error lines from interleaving
+};
+
+class RenderJob : public QRunnable
+{
+public:
+    RenderJob(const QString &fileName, const RenderOptions &options, RenderTotals &totals)
+        : m_fileName(fileName), m_options(options), m_totals(totals)
+    {
+    }
+
+    void run() override
+    {
+        QString error;
+        if (render(&error)) {
+            m_totals.rendered++;
+            return;
+        }
+
+        m_totals.failed++;
+        QMutexLocker locker(&m_totals.outputMutex);
+        QTextStream(stderr) << m_fileName << ": " << error << '\n';
+    }
+
+private:
+    bool render(QString *error)
+    {
+        QVector<PlanRecord> records;
+        if (!PlanLoader::load(m_fileName, records, error))
+            return false;
+
+        /* The scene lives and dies in this thread, nothing else sees it.
+         * It is drawn exactly once, so building an index would be wasted. */
+        PlanScene scene;
+        scene.setItemIndexMethod(QGraphicsScene::NoIndex);
+        for (const PlanRecord &record : records)
+            scene.addRecord(record);
+
+        const QImage image = scene.toImage(m_options.scale, m_options.margin);
+
+        const QFileInfo input(m_fileName);
+        const QString dir = m_options.outputDir.isEmpty() ? input.absolutePath()
+                                                          : m_options.outputDir;
+        const QString output = dir + "/" + input.completeBaseName() + ".png";
+        if (!image.save(output, "PNG")) {
+            *error = "could not write " + output;
+            return false;
+        }
+
+        m_totals.items += records.size();
+        return true;
+    }
+
+    QString m_fileName;
+    RenderOptions m_options;
+    RenderTotals &m_totals;
+};
+
+static QStringList collectPlans(const QStringList &paths)
+{
+    const QStringList filters = { "*.hp2d", "*.hp2b", "*.json" };
+    QStringList plans;
+
+    for (const QString &path : paths) {
+        if (!QFileInfo(path).isDir()) {
+            plans.append(path);
+            continue;
+        }
+
+        QDirIterator it(path, filters, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            plans.append(it.next());
+    }
+    return plans;
+}
+
+int main(int argc, char *argv[])
+{
+    /* No display needed, not even when one is available */
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("batch_render");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders Home Planner 2D plans to PNG images.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("plans", "Plan files or directories containing them.",
+                                 "<plan>...");
+
+    QCommandLineOption outputOption({ "o", "output" },
+        "Write images to <dir> instead of next to the plans.", "dir");
+    QCommandLineOption jobsOption({ "j", "jobs" },
+        "Render <n> plans at once, defaults to the number of cores.", "n",
+        QString::number(QThread::idealThreadCount()));
+    QCommandLineOption scaleOption({ "s", "scale" },
+        "Image pixels per scene unit.", "factor", "1");
+    QCommandLineOption marginOption({ "m", "margin" },
+        "White border around the plan, in image pixels.", "px", "10");
+    parser.addOptions({ outputOption, jobsOption, scaleOption, marginOption });
+    parser.process(app);
+
+    RenderOptions options;
+    options.outputDir = parser.value(outputOption);
+    options.scale = parser.value(scaleOption).toDouble();
+    options.margin = parser.value(marginOption).toInt();
+    const int jobs = parser.value(jobsOption).toInt();
+
+    if (options.scale <= 0 || jobs <= 0) {
+        QTextStream(stderr) << "Scale and jobs must be positive" << '\n';
+        return 2;
+    }
+    if (!options.outputDir.isEmpty() && !QDir().mkpath(options.outputDir)) {
+        QTextStream(stderr) << "Could not create " << options.outputDir << '\n';
+        return 2;
+    }
+
+    const QStringList plans = collectPlans(parser.positionalArguments());
+    if (plans.isEmpty())
+        parser.showHelp(2);
+
+    RenderTotals totals;
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (const QString &plan : plans)
+        pool.start(new RenderJob(plan, options, totals));
+    pool.waitForDone();
+
+    const double seconds = qMax<qint64>(timer.elapsed(), 1) / 1000.0;
+    const int rendered = totals.rendered.load();
+    const qint64 items = totals.items.load();
+    QTextStream(stdout)
+        << "Rendered " << rendered << " of " << plans.size() << " plans ("
+        << items << " items) in " << seconds << " s on " << jobs << " threads, "
+        << rendered / seconds << " plans/s, " << items / seconds << " items/s" << '\n';
+
+    return totals.failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,11 @@
+QT = core
+
+TARGET = generate_plan
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../../src/core.pri)
+
+SOURCES += main.cpp
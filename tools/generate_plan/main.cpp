@@ -0,0 +1,68 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "plan_generator.hpp"
+#include "project_file.hpp"
+#include "json_interchange.hpp"
+
+/*
+ * Writes a generated plan, see PlanGenerator:
+ *
+ *   generate_plan [-l apartment|house|office] [-r <rooms>] [-s <seed>] [-d <density>] <file>
+ *
+ * *.json files get the JSON interchange format, everything else the
+ * binary project format. The same options always write the same plan.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("generate_plan");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates Home Planner 2D plans for load tests and benchmarks.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("file", "Plan file to write, *.hp2d or *.json.", "<file>");
+
+    QCommandLineOption layoutOption({ "l", "layout" },
+        "Kind of plan: apartment, house or office.", "layout", "apartment");
+    QCommandLineOption roomsOption({ "r", "rooms" },
+        "Number of rooms.", "rooms", "5");
+    QCommandLineOption seedOption({ "s", "seed" },
+        "Seed, different seeds give different plans.", "seed", "1");
+    QCommandLineOption densityOption({ "d", "density" },
+        "Furniture per room, 1 is a typical home.", "density", "1");
+    parser.addOptions({ layoutOption, roomsOption, seedOption, densityOption });
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(2);
+
+    PlanGenerator::Options options;
+    bool ok = PlanGenerator::layoutFromName(parser.value(layoutOption), &options.layout);
+    bool roomsOk, seedOk, densityOk;
+    options.rooms = parser.value(roomsOption).toInt(&roomsOk);
+    options.seed = parser.value(seedOption).toUInt(&seedOk);
+    options.density = parser.value(densityOption).toDouble(&densityOk);
+
+    if (!ok || !roomsOk || !seedOk || !densityOk || options.rooms <= 0 || options.density < 0) {
+        QTextStream(stderr) << "Invalid options, see --help" << '\n';
+        return 2;
+    }
+
+    const QVector<PlanRecord> records = PlanGenerator::generate(options);
+
+    const QString fileName = parser.positionalArguments().first();
+    QString error;
+    const bool saved = fileName.endsWith(".json", Qt::CaseInsensitive)
+            ? JsonInterchange::save(fileName, records, &error)
+            : ProjectWriter::save(fileName, records, &error);
+    if (!saved) {
+        QTextStream(stderr) << error << '\n';
+        return 1;
+    }
+
+    QTextStream(stdout) << "Wrote " << records.size() << " items (" << options.rooms << " rooms) to "
+                        << fileName << '\n';
+    return 0;
+}
@@ -0,0 +1,8 @@
+# Command line tools, they run without a display
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+        batch_render \
+        analyze_plans \
+        generate_plan